@@ -1,27 +1,50 @@
 // swift-tools-version: 6.3
 import PackageDescription
 
+// OpenConnectKit comes from a sibling checkout during development. Release
+// and CI builds on hosts without one set OPENCONNECTKIT_URL (and optionally
+// OPENCONNECTKIT_BRANCH, default main) to fetch it instead.
+let openConnectKit: Package.Dependency = {
+  guard let url = Context.environment["OPENCONNECTKIT_URL"] else {
+    return .package(path: Context.environment["OPENCONNECTKIT_PATH"] ?? "../OpenConnectKit")
+  }
+  return .package(
+    url: url, branch: Context.environment["OPENCONNECTKIT_BRANCH"] ?? "main")
+}()
+
 let package = Package(
   name: "SwiftConnectCli",
+  // Minimum for Apple platforms only; Linux (glibc, or musl through the
+  // static Linux SDK) is supported too, see scripts/build-linux.sh
   platforms: [.macOS(.v26)],
   products: [
     .executable(name: "swiftconnect-cli", targets: ["SwiftConnectCli"])
   ],
   dependencies: [
     .package(url: "https://github.com/apple/swift-argument-parser", from: "1.3.0"),
-    .package(path: "../OpenConnectKit"),
-    //.package(url: "https://github.com/zoltan-magyar/OpenConnectKit.git"),
+    .package(url: "https://github.com/apple/swift-crypto", from: "3.0.0"),
+    openConnectKit,
   ],
   targets: [
+    // USDT probes and other helpers that need C
+    .target(name: "CSwiftConnectSupport"),
     .executableTarget(
       name: "SwiftConnectCli",
       dependencies: [
+        "CSwiftConnectSupport",
         .product(name: "OpenConnectKit", package: "OpenConnectKit"),
         .product(name: "ArgumentParser", package: "swift-argument-parser"),
+        // CryptoKit stand-in for TOTP generation off Apple platforms
+        .product(name: "Crypto", package: "swift-crypto", condition: .when(platforms: [.linux])),
       ],
       swiftSettings: [
         .enableUpcomingFeature("NonisolatedNonsendingByDefault")
       ]
-    )
+    ),
+    // Parsers and codecs
+    .testTarget(
+      name: "SwiftConnectCliTests",
+      dependencies: ["SwiftConnectCli", "CSwiftConnectSupport"]
+    ),
   ]
 )
@@ -0,0 +1,235 @@
+//
+//  flight_recorder.c
+//  SwiftConnectCli
+//
+//  Ring buffer behind flight_recorder.h
+//
+
+#include "flight_recorder.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Offsets into the ring are byte counts since startup; the physical position
+// is offset % capacity. `tail` is the start of the oldest complete record and
+// `head` the end of the newest one, so [tail, head) always parses.
+static struct {
+  uint8_t *buffer;
+  size_t capacity;
+  _Atomic uint64_t head;
+  _Atomic uint64_t tail;
+  atomic_flag lock;
+} ring = {.lock = ATOMIC_FLAG_INIT};
+
+static char crash_path[PATH_MAX];
+static uint64_t crash_window_ns;
+
+// The handler runs here, so a stack overflow can still be dumped. Large
+// enough for the dump, which keeps its state in registers and statics.
+static uint8_t crash_stack[64 * 1024];
+
+static uint64_t now_ns(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Copies in and out of the ring, splitting at the wrap point.
+static void ring_write(uint64_t offset, const void *data, size_t length) {
+  size_t position = offset % ring.capacity;
+  size_t first = ring.capacity - position < length ? ring.capacity - position : length;
+  memcpy(ring.buffer + position, data, first);
+  memcpy(ring.buffer, (const uint8_t *)data + first, length - first);
+}
+
+static void ring_read(uint64_t offset, void *data, size_t length) {
+  size_t position = offset % ring.capacity;
+  size_t first = ring.capacity - position < length ? ring.capacity - position : length;
+  memcpy(data, ring.buffer + position, first);
+  memcpy((uint8_t *)data + first, ring.buffer, length - first);
+}
+
+static void ring_lock(void) {
+  while (atomic_flag_test_and_set_explicit(&ring.lock, memory_order_acquire)) {
+  }
+}
+
+static void ring_unlock(void) {
+  atomic_flag_clear_explicit(&ring.lock, memory_order_release);
+}
+
+static size_t record_size_at(uint64_t offset, uint64_t *timestamp) {
+  uint8_t header[SCS_FR_RECORD_HEADER_SIZE];
+  ring_read(offset, header, sizeof header);
+  uint16_t length;
+  memcpy(&length, header + 10, sizeof length);
+  if (timestamp) memcpy(timestamp, header, sizeof *timestamp);
+  return SCS_FR_RECORD_HEADER_SIZE + length;
+}
+
+int scs_fr_init(size_t capacity) {
+  if (ring.buffer || capacity < 4096) return -1;
+  ring.buffer = malloc(capacity);
+  if (!ring.buffer) return -1;
+  ring.capacity = capacity;
+  return 0;
+}
+
+void scs_fr_record(uint8_t kind, uint8_t level, const void *data, size_t length) {
+  if (!ring.buffer) return;
+  if (length > UINT16_MAX) length = UINT16_MAX;
+  if (SCS_FR_RECORD_HEADER_SIZE + length > ring.capacity) return;
+
+  uint8_t header[SCS_FR_RECORD_HEADER_SIZE];
+  uint64_t timestamp = now_ns(CLOCK_MONOTONIC);
+  uint16_t length16 = (uint16_t)length;
+  memcpy(header, &timestamp, sizeof timestamp);
+  header[8] = kind;
+  header[9] = level;
+  memcpy(header + 10, &length16, sizeof length16);
+
+  ring_lock();
+
+  uint64_t head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+  uint64_t tail = atomic_load_explicit(&ring.tail, memory_order_relaxed);
+  uint64_t end = head + SCS_FR_RECORD_HEADER_SIZE + length;
+
+  // Drop the oldest records until the new one fits
+  while (end - tail > ring.capacity) {
+    tail += record_size_at(tail, NULL);
+  }
+  atomic_store_explicit(&ring.tail, tail, memory_order_release);
+
+  ring_write(head, header, sizeof header);
+  ring_write(head + sizeof header, data, length);
+  atomic_store_explicit(&ring.head, end, memory_order_release);
+
+  ring_unlock();
+}
+
+static int write_all(int fd, const void *data, size_t length) {
+  const uint8_t *bytes = data;
+  while (length > 0) {
+    ssize_t written = write(fd, bytes, length);
+    if (written < 0) return -1;
+    bytes += written;
+    length -= (size_t)written;
+  }
+  return 0;
+}
+
+// Writes the dump header; `monotonic_out` receives the timestamp it carries.
+static int write_header(int fd, uint64_t *monotonic_out) {
+  uint8_t header[SCS_FR_HEADER_SIZE];
+  uint32_t version = SCS_FR_VERSION;
+  uint64_t realtime = now_ns(CLOCK_REALTIME);
+  uint64_t monotonic = now_ns(CLOCK_MONOTONIC);
+  memcpy(header, SCS_FR_MAGIC, 4);
+  memcpy(header + 4, &version, sizeof version);
+  memcpy(header + 8, &realtime, sizeof realtime);
+  memcpy(header + 16, &monotonic, sizeof monotonic);
+  *monotonic_out = monotonic;
+  return write_all(fd, header, sizeof header);
+}
+
+// First record inside the window, walking forward from the tail.
+static uint64_t window_start(
+    uint64_t start, uint64_t head, uint64_t monotonic, uint64_t window_ns) {
+  uint64_t cutoff = window_ns && window_ns < monotonic ? monotonic - window_ns : 0;
+  while (start < head) {
+    uint64_t timestamp;
+    size_t size = record_size_at(start, &timestamp);
+    if (timestamp >= cutoff) break;
+    start += size;
+  }
+  return start;
+}
+
+int scs_fr_dump(int fd, uint64_t window_ns) {
+  uint64_t monotonic;
+  if (write_header(fd, &monotonic) < 0) return -1;
+  if (!ring.buffer) return 0;
+
+  // Writers keep appending while the file is written, so the window is
+  // copied out under the lock first; write(2) never runs with it held
+  uint8_t *scratch = malloc(ring.capacity);
+  if (!scratch) return -1;
+
+  ring_lock();
+  uint64_t head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+  uint64_t start = window_start(
+      atomic_load_explicit(&ring.tail, memory_order_relaxed), head, monotonic, window_ns);
+  size_t length = (size_t)(head - start);
+  ring_read(start, scratch, length);
+  ring_unlock();
+
+  int result = write_all(fd, scratch, length);
+  free(scratch);
+  return result;
+}
+
+// Crash-time dump straight from the ring. The crashing thread may hold the
+// lock, so it is not taken; a record being appended at the same moment can
+// come out torn, which beats not dumping at all.
+static int dump_unlocked(int fd, uint64_t window_ns) {
+  uint64_t monotonic;
+  if (write_header(fd, &monotonic) < 0) return -1;
+  if (!ring.buffer) return 0;
+
+  uint64_t head = atomic_load_explicit(&ring.head, memory_order_acquire);
+  uint64_t start = window_start(
+      atomic_load_explicit(&ring.tail, memory_order_acquire), head, monotonic, window_ns);
+
+  // At most two contiguous pieces
+  while (start < head) {
+    size_t position = start % ring.capacity;
+    size_t length = head - start;
+    if (length > ring.capacity - position) length = ring.capacity - position;
+    if (write_all(fd, ring.buffer + position, length) < 0) return -1;
+    start += length;
+  }
+  return 0;
+}
+
+static void crash_handler(int signal_number) {
+  int fd = open(crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd >= 0) {
+    dump_unlocked(fd, crash_window_ns);
+    close(fd);
+  }
+
+  // Let the default action produce the usual exit status and core dump
+  signal(signal_number, SIG_DFL);
+  raise(signal_number);
+}
+
+int scs_fr_install_crash_handler(const char *path, uint64_t window_ns) {
+  if (strlen(path) >= sizeof crash_path) return -1;
+  strcpy(crash_path, path);
+  crash_window_ns = window_ns;
+
+  stack_t stack;
+  memset(&stack, 0, sizeof stack);
+  stack.ss_sp = crash_stack;
+  stack.ss_size = sizeof crash_stack;
+  if (sigaltstack(&stack, NULL) < 0) return -1;
+
+  struct sigaction action;
+  memset(&action, 0, sizeof action);
+  action.sa_handler = crash_handler;
+  action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+
+  // Swift runtime traps arrive as SIGILL on x86_64 and SIGTRAP on arm64
+  const int signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGTRAP, SIGFPE, SIGABRT};
+  for (size_t i = 0; i < sizeof signals / sizeof signals[0]; i++) {
+    if (sigaction(signals[i], &action, NULL) < 0) return -1;
+  }
+  return 0;
+}
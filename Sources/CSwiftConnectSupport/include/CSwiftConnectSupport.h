@@ -0,0 +1,21 @@
+//
+//  CSwiftConnectSupport.h
+//  SwiftConnectCli
+//
+//  C helpers for things Swift cannot express directly
+//
+
+#ifndef CSWIFTCONNECTSUPPORT_H
+#define CSWIFTCONNECTSUPPORT_H
+
+#include "flight_recorder.h"
+#include "packet_memory.h"
+#include "packet_ring.h"
+#include "probes.h"
+#include "profiler.h"
+#include "resources.h"
+#include "startup.h"
+#include "stats_segment.h"
+#include "terminal.h"
+
+#endif /* CSWIFTCONNECTSUPPORT_H */
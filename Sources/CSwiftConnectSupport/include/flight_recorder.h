@@ -0,0 +1,58 @@
+//
+//  flight_recorder.h
+//  SwiftConnectCli
+//
+//  Always-on in-memory ring of recent log records and events
+//
+//  Records are appended in a compact binary form with a monotonic timestamp
+//  and are only formatted when a dump is decoded. The ring has a fixed size
+//  chosen at startup; the oldest records are dropped to make room.
+//
+//  scs_fr_dump() copies the window out under the ring lock, so a dump taken
+//  while other threads log is consistent. The crash handler writes straight
+//  from the ring without the lock instead.
+//
+
+#ifndef SWIFTCONNECT_FLIGHT_RECORDER_H
+#define SWIFTCONNECT_FLIGHT_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Dump file layout (all integers little-endian):
+//
+//   header:  "SCFR" | u32 version | u64 realtime_ns | u64 monotonic_ns
+//   records: u64 monotonic_ns | u8 kind | u8 level | u16 length | length bytes
+//
+// The header timestamps are taken together at dump time so a decoder can
+// convert record timestamps to wall-clock time.
+#define SCS_FR_MAGIC "SCFR"
+#define SCS_FR_VERSION 1
+#define SCS_FR_HEADER_SIZE 24
+#define SCS_FR_RECORD_HEADER_SIZE 12
+
+enum {
+  SCS_FR_KIND_LOG = 0,
+  SCS_FR_KIND_EVENT = 1,
+};
+
+// Allocates the ring. Returns 0 on success, -1 if it is already set up or
+// memory cannot be allocated.
+int scs_fr_init(size_t capacity);
+
+// Appends a record; a no-op before scs_fr_init(). Payloads longer than
+// 65535 bytes are truncated. Safe to call from any thread.
+void scs_fr_record(uint8_t kind, uint8_t level, const void *data, size_t length);
+
+// Writes the records from the last `window_ns` nanoseconds (0 for all) to fd.
+// Not async-signal-safe: it takes the ring lock and allocates a copy of the
+// window. Returns 0 on success, -1 on allocation or write failure.
+int scs_fr_dump(int fd, uint64_t window_ns);
+
+// Installs handlers for SIGSEGV, SIGBUS, SIGILL, SIGTRAP, SIGFPE and SIGABRT
+// that dump the last `window_ns` to `path` and then re-raise the signal. They
+// run on an alternate signal stack set up for the calling thread, so call it
+// from the main thread; other threads crash on their own stacks.
+int scs_fr_install_crash_handler(const char *path, uint64_t window_ns);
+
+#endif /* SWIFTCONNECT_FLIGHT_RECORDER_H */
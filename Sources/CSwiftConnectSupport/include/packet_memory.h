@@ -0,0 +1,37 @@
+//
+//  packet_memory.h
+//  SwiftConnectCli
+//
+//  Huge-page backed, prefaulted memory for packet buffers
+//
+//  A region is mapped once at start-up in 2 MiB units. hugetlbfs pages
+//  (MAP_HUGETLB) are tried first; without reserved huge pages the region is
+//  aligned to 2 MiB and advised for transparent huge pages instead, and
+//  elsewhere it is plain anonymous memory. Every page is touched before
+//  returning so the data path never takes a first-touch fault, and the region
+//  can be locked so it is never paged out either.
+//
+
+#ifndef SWIFTCONNECT_PACKET_MEMORY_H
+#define SWIFTCONNECT_PACKET_MEMORY_H
+
+#include <stddef.h>
+
+#define SCS_HUGE_PAGE_SIZE (2u * 1024 * 1024)
+
+typedef enum {
+  SCS_PAGES_HUGETLB = 0,
+  SCS_PAGES_TRANSPARENT = 1,
+  SCS_PAGES_NORMAL = 2,
+} scs_page_kind;
+
+// Maps and prefaults `bytes` rounded up to SCS_HUGE_PAGE_SIZE, storing the
+// rounded size in `*mapped` and the kind of pages in `*kind`. With `lock`,
+// mlocks the region and stores whether that worked in `*locked`; when it did
+// not, errno says why. Returns NULL with errno set if nothing could be mapped.
+void *scs_region_map(size_t bytes, int lock, size_t *mapped, scs_page_kind *kind, int *locked);
+
+// Releases a region returned by scs_region_map.
+void scs_region_unmap(void *region, size_t mapped);
+
+#endif /* SWIFTCONNECT_PACKET_MEMORY_H */
@@ -0,0 +1,66 @@
+//
+//  packet_ring.h
+//  SwiftConnectCli
+//
+//  Memory-mapped AF_PACKET receive ring (TPACKET_V2) for in-process capture
+//
+//  The kernel copies each packet once, into a ring shared with the process,
+//  and a classic BPF filter attached to the socket drops unwanted packets and
+//  truncates the rest to the snap length before that copy. Nothing exists
+//  while capture is off. Linux only; elsewhere scs_packet_ring_open() fails
+//  with ENOSYS.
+//
+
+#ifndef SWIFTCONNECT_PACKET_RING_H
+#define SWIFTCONNECT_PACKET_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One classic BPF instruction, laid out like struct sock_filter.
+typedef struct {
+  uint16_t code;
+  uint8_t jt;
+  uint8_t jf;
+  uint32_t k;
+} scs_bpf_insn;
+
+typedef struct {
+  int fd;
+  void *map;
+  size_t map_size;
+  unsigned frame_size;
+  unsigned frame_count;
+  unsigned next;
+} scs_packet_ring;
+
+typedef struct {
+  uint64_t timestamp_ns;
+  uint32_t captured_length;
+  uint32_t original_length;
+  const uint8_t *data;
+} scs_packet;
+
+// Opens a ring of about `ring_bytes` on interface `ifname`, capturing both
+// directions from the network header on, with `filter` attached before the
+// ring is mapped. Returns 0, or -1 with errno set.
+int scs_packet_ring_open(scs_packet_ring *ring, const char *ifname, uint32_t snaplen,
+                         size_t ring_bytes, const scs_bpf_insn *filter, uint16_t filter_length);
+
+// Returns 1 and fills `packet` if a frame is ready, 0 if the ring is empty.
+// The frame stays valid until scs_packet_ring_release().
+int scs_packet_ring_next(scs_packet_ring *ring, scs_packet *packet);
+
+// Hands the frame returned by the last scs_packet_ring_next() back to the kernel.
+void scs_packet_ring_release(scs_packet_ring *ring);
+
+// Waits up to `timeout_ms` for frames. Returns poll(2)'s result, or -1 with
+// errno set when the socket reports an error.
+int scs_packet_ring_wait(scs_packet_ring *ring, int timeout_ms);
+
+// Packets received and dropped for lack of ring space since the last call.
+void scs_packet_ring_stats(scs_packet_ring *ring, uint32_t *packets, uint32_t *drops);
+
+void scs_packet_ring_close(scs_packet_ring *ring);
+
+#endif /* SWIFTCONNECT_PACKET_RING_H */
@@ -0,0 +1,104 @@
+//
+//  probes.h
+//  SwiftConnectCli
+//
+//  USDT (SystemTap SDT) probes for session events
+//
+//  Each probe has an is-enabled check backed by an SDT semaphore. The
+//  semaphore is only non-zero while a tracer (bpftrace, perf, stap) is
+//  attached, so disabled probes cost a single predictable branch and no
+//  argument marshalling. Without <sys/sdt.h> every probe compiles to nothing.
+//
+//  List the probes with:   bpftrace -l 'usdt:/path/to/swiftconnect-cli:*'
+//
+
+#ifndef SWIFTCONNECT_PROBES_H
+#define SWIFTCONNECT_PROBES_H
+
+#include <stdint.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define SCS_HAVE_SDT 1
+#endif
+#endif
+
+#if SCS_HAVE_SDT
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define SCS_SEMAPHORE(name) swiftconnect_##name##_semaphore
+#define SCS_DECLARE_SEMAPHORE(name) extern volatile unsigned short SCS_SEMAPHORE(name);
+#define SCS_ENABLED(name) __builtin_expect(SCS_SEMAPHORE(name) != 0, 0)
+#else
+// Arguments are still evaluated as void so the wrappers build without
+// unused-parameter warnings
+#define SCS_DECLARE_SEMAPHORE(name)
+#define SCS_ENABLED(name) 0
+#define STAP_PROBE1(provider, name, a1) ((void)(a1))
+#define STAP_PROBE2(provider, name, a1, a2) ((void)(a1), (void)(a2))
+#define STAP_PROBE3(provider, name, a1, a2, a3) ((void)(a1), (void)(a2), (void)(a3))
+#define STAP_PROBE4(provider, name, a1, a2, a3, a4) \
+  ((void)(a1), (void)(a2), (void)(a3), (void)(a4))
+#endif
+
+SCS_DECLARE_SEMAPHORE(status)
+SCS_DECLARE_SEMAPHORE(auth_begin)
+SCS_DECLARE_SEMAPHORE(auth_end)
+SCS_DECLARE_SEMAPHORE(reconnect)
+SCS_DECLARE_SEMAPHORE(stats)
+SCS_DECLARE_SEMAPHORE(forward_open)
+
+// status(int code, const char *detail)
+// Connection status change; code is one of the SCS_STATUS_* values and
+// detail the connecting stage or disconnect error, if any.
+enum {
+  SCS_STATUS_DISCONNECTED = 0,
+  SCS_STATUS_CONNECTING = 1,
+  SCS_STATUS_CONNECTED = 2,
+  SCS_STATUS_RECONNECTING = 3,
+  SCS_STATUS_DISCONNECTING = 4,
+};
+
+static inline int scs_probe_status_enabled(void) { return SCS_ENABLED(status); }
+static inline void scs_probe_status(int code, const char *detail) {
+  STAP_PROBE2(swiftconnect, status, code, detail);
+}
+
+// auth_begin(const char *title, int fields)
+// An authentication form arrived from the server.
+static inline int scs_probe_auth_begin_enabled(void) { return SCS_ENABLED(auth_begin); }
+static inline void scs_probe_auth_begin(const char *title, int fields) {
+  STAP_PROBE2(swiftconnect, auth_begin, title, fields);
+}
+
+// auth_end(uint64_t duration_ns, int answered, int prompted)
+// The form is returned to the server; duration covers rules and prompts.
+static inline int scs_probe_auth_end_enabled(void) { return SCS_ENABLED(auth_end); }
+static inline void scs_probe_auth_end(uint64_t duration_ns, int answered, int prompted) {
+  STAP_PROBE3(swiftconnect, auth_end, duration_ns, answered, prompted);
+}
+
+// reconnect(uint64_t count)
+// The session lost its connection and is reconnecting; count starts at 1.
+static inline int scs_probe_reconnect_enabled(void) { return SCS_ENABLED(reconnect); }
+static inline void scs_probe_reconnect(uint64_t count) {
+  STAP_PROBE1(swiftconnect, reconnect, count);
+}
+
+// stats(uint64_t rx_bytes, uint64_t tx_bytes, uint64_t rx_packets, uint64_t tx_packets)
+// A statistics sample was received.
+static inline int scs_probe_stats_enabled(void) { return SCS_ENABLED(stats); }
+static inline void scs_probe_stats(uint64_t rx_bytes, uint64_t tx_bytes, uint64_t rx_packets,
+                                   uint64_t tx_packets) {
+  STAP_PROBE4(swiftconnect, stats, rx_bytes, tx_bytes, rx_packets, tx_packets);
+}
+
+// forward_open(int local_port, uint64_t latency_ns, int ok)
+// A port-forward connection was set up (or failed) through the tunnel.
+static inline int scs_probe_forward_open_enabled(void) { return SCS_ENABLED(forward_open); }
+static inline void scs_probe_forward_open(int local_port, uint64_t latency_ns, int ok) {
+  STAP_PROBE3(swiftconnect, forward_open, local_port, latency_ns, ok);
+}
+
+#endif /* SWIFTCONNECT_PROBES_H */
@@ -0,0 +1,55 @@
+//
+//  profiler.h
+//  SwiftConnectCli
+//
+//  Built-in sampling profiler: SIGPROF timer plus frame-pointer unwinding
+//
+//  While running, ITIMER_PROF delivers SIGPROF to whichever thread is using
+//  CPU, at the requested frequency of process CPU time. The handler walks
+//  that thread's frame-pointer chain into a preallocated sample buffer; it
+//  allocates nothing and takes no locks. Addresses are stored raw and are
+//  resolved to module+offset after the run, for offline symbolization.
+//
+//  Frames compiled without frame pointers are skipped over or end the walk
+//  early. The walk only follows frame pointers that move up the stack by
+//  less than SCS_PROF_MAX_FRAME bytes per frame and stay below the top of the
+//  interrupted thread's stack. On Linux stack extents come from a snapshot of
+//  /proc/self/maps taken at start; threads created later are sampled with
+//  their pc only.
+//
+
+#ifndef SWIFTCONNECT_PROFILER_H
+#define SWIFTCONNECT_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCS_PROF_MAX_DEPTH 64
+#define SCS_PROF_MAX_FRAME (1u << 20)
+
+typedef struct {
+  uint64_t thread_id;
+  // Set last; zero means the sample was never completed
+  uint32_t depth;
+  uint32_t reserved;
+  // Innermost first: the interrupted pc, then return addresses
+  uint64_t frames[SCS_PROF_MAX_DEPTH];
+} scs_profile_sample;
+
+// Starts sampling at `frequency` Hz into room for `capacity` samples.
+// Returns 0, or -1 with errno set (EBUSY if a profile is already running).
+int scs_profiler_start(unsigned frequency, size_t capacity);
+
+// Stops sampling. Returns the number of samples taken and stores those that
+// did not fit in `dropped`. The samples stay valid until the next start, so
+// callers reading them must keep other starts out until they are done.
+size_t scs_profiler_stop(size_t *dropped);
+
+// Samples of the last run; entries with depth 0 are incomplete.
+const scs_profile_sample *scs_profiler_samples(void);
+
+// Resolves `address` to the file of the module containing it and the offset
+// from that module's load address. Returns 0, or -1 if no module matches.
+int scs_profiler_module(uint64_t address, const char **path, uint64_t *offset);
+
+#endif /* SWIFTCONNECT_PROFILER_H */
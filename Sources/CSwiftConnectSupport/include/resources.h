@@ -0,0 +1,19 @@
+//
+//  resources.h
+//  SwiftConnectCli
+//
+//  Process memory figures that need platform allocator or kernel APIs
+//
+
+#ifndef SWIFTCONNECT_RESOURCES_H
+#define SWIFTCONNECT_RESOURCES_H
+
+#include <stdint.h>
+
+// Bytes currently allocated through malloc, or 0 if the allocator cannot say.
+uint64_t scs_heap_in_use(void);
+
+// Resident set size of this process in bytes, or 0 if unknown.
+uint64_t scs_resident_bytes(void);
+
+#endif /* SWIFTCONNECT_RESOURCES_H */
@@ -0,0 +1,32 @@
+//
+//  startup.h
+//  SwiftConnectCli
+//
+//  Start-up timestamps from before Swift code runs
+//
+//  All values are CLOCK_MONOTONIC nanoseconds, the clock BinaryLog and the
+//  start-up metrics use, so they can be subtracted from each other directly.
+//
+
+#ifndef SWIFTCONNECT_STARTUP_H
+#define SWIFTCONNECT_STARTUP_H
+
+#include <stdint.h>
+
+// Environment variable a harness sets to the CLOCK_REALTIME nanoseconds just
+// before exec (e.g. `date +%s%N`), for an origin finer than the kernel's.
+#define SCS_STARTUP_EXEC_ENV "SWIFTCONNECT_EXEC_REALTIME_NS"
+
+// When the process was exec'd: from SCS_STARTUP_EXEC_ENV when set, else from
+// the kernel's process start time (10 ms ticks on Linux, truncated, so up to
+// 10 ms early), or 0 if unknown.
+uint64_t scs_startup_exec_ns(void);
+
+// When this library's constructor ran: after the dynamic loader mapped and
+// relocated every library, just before main.
+uint64_t scs_startup_constructor_ns(void);
+
+// CLOCK_MONOTONIC now.
+uint64_t scs_monotonic_ns(void);
+
+#endif /* SWIFTCONNECT_STARTUP_H */
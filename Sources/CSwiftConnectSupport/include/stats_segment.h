@@ -0,0 +1,89 @@
+//
+//  stats_segment.h
+//  SwiftConnectCli
+//
+//  Live session state published in POSIX shared memory
+//
+//  Each session maps /swiftconnect-<pid> (/dev/shm/swiftconnect-<pid> on
+//  Linux). A single writer updates it under a sequence lock: the sequence is
+//  odd while an update is in progress. Readers copy the segment and retry
+//  when the sequence was odd or changed, so they never block the session and
+//  the session never makes a syscall for them.
+//
+//  New fields are only ever appended. Readers check `magic` and `version`
+//  and use no field beyond `size`.
+//
+
+#ifndef SWIFTCONNECT_STATS_SEGMENT_H
+#define SWIFTCONNECT_STATS_SEGMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCS_STATS_MAGIC 0x53435353u /* "SCSS" */
+#define SCS_STATS_VERSION 1
+#define SCS_STATS_RTT_SAMPLES 64
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  int32_t pid;
+  uint64_t sequence;
+
+  // CLOCK_REALTIME nanoseconds
+  uint64_t started_ns;
+  uint64_t updated_ns;
+
+  // One of the SCS_STATUS_* values from probes.h
+  uint32_t status;
+  uint32_t reconnects;
+  char server[256];
+  char gateway[64];
+  char interface[32];
+
+  uint64_t rx_bytes;
+  uint64_t tx_bytes;
+  uint64_t rx_packets;
+  uint64_t tx_packets;
+  // Bytes per second between the last two counter samples
+  double rx_rate;
+  double tx_rate;
+
+  // Round-trip times to the gateway in microseconds; rtt_count samples were
+  // taken in total, the newest at (rtt_count - 1) % SCS_STATS_RTT_SAMPLES
+  uint64_t rtt_count;
+  uint32_t rtt_us[SCS_STATS_RTT_SAMPLES];
+
+  // The session's own resource use, sampled with the statistics
+  uint64_t cpu_ns;
+  uint64_t resident_bytes;
+  uint64_t heap_bytes;
+  uint64_t voluntary_switches;
+  uint64_t involuntary_switches;
+  uint64_t minor_faults;
+  uint64_t major_faults;
+  uint32_t threads;
+  uint32_t reserved;
+} scs_stats_segment;
+
+// Creates and maps this process's segment. Returns NULL with errno set.
+scs_stats_segment *scs_stats_create(int pid);
+
+// Maps the segment of session `pid` read-only. Returns NULL with errno set.
+const scs_stats_segment *scs_stats_attach(int pid);
+
+void scs_stats_detach(const scs_stats_segment *segment);
+
+// Removes the segment name of session `pid`.
+void scs_stats_unlink(int pid);
+
+// Bracket every update; only one thread may write at a time.
+void scs_stats_write_begin(scs_stats_segment *segment);
+void scs_stats_write_end(scs_stats_segment *segment);
+
+// Copies a consistent snapshot. Returns 0, or -1 if the segment has an
+// unknown format or stayed busy.
+int scs_stats_read(const scs_stats_segment *segment, scs_stats_segment *snapshot);
+
+#endif /* SWIFTCONNECT_STATS_SEGMENT_H */
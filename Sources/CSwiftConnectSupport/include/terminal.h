@@ -0,0 +1,23 @@
+//
+//  terminal.h
+//  SwiftConnectCli
+//
+//  Terminal queries that go through variadic ioctl(2)
+//
+
+#ifndef SWIFTCONNECT_TERMINAL_H
+#define SWIFTCONNECT_TERMINAL_H
+
+#include <sys/ioctl.h>
+
+// Stores the window size of terminal `fd`. Returns 0, or -1 if `fd` is not a
+// terminal.
+static inline int scs_terminal_size(int fd, int *rows, int *columns) {
+  struct winsize size;
+  if (ioctl(fd, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) return -1;
+  *rows = size.ws_row;
+  *columns = size.ws_col;
+  return 0;
+}
+
+#endif /* SWIFTCONNECT_TERMINAL_H */
@@ -0,0 +1,87 @@
+//
+//  packet_memory.c
+//  SwiftConnectCli
+//
+//  Region mapping behind packet_memory.h
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "packet_memory.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Writes to every page so all of them are resident before use
+static void prefault(unsigned char *region, size_t bytes) {
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  for (size_t offset = 0; offset < bytes; offset += page) {
+    ((volatile unsigned char *)region)[offset] = 0;
+  }
+}
+
+// Anonymous mapping aligned to SCS_HUGE_PAGE_SIZE: over-map, then trim
+static void *map_aligned(size_t bytes) {
+  size_t padded = bytes + SCS_HUGE_PAGE_SIZE;
+  unsigned char *raw = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) return NULL;
+
+  uintptr_t start = ((uintptr_t)raw + SCS_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(SCS_HUGE_PAGE_SIZE - 1);
+  size_t head = start - (uintptr_t)raw;
+  if (head) munmap(raw, head);
+  size_t tail = padded - head - bytes;
+  if (tail) munmap((unsigned char *)start + bytes, tail);
+  return (void *)start;
+}
+
+void *scs_region_map(size_t bytes, int lock, size_t *mapped, scs_page_kind *kind, int *locked) {
+  if (bytes == 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+  bytes = (bytes + SCS_HUGE_PAGE_SIZE - 1) & ~(size_t)(SCS_HUGE_PAGE_SIZE - 1);
+  *mapped = bytes;
+  *locked = 0;
+
+  void *region = NULL;
+#if defined(MAP_HUGETLB)
+  // Fails with ENOMEM unless enough pages are reserved in vm.nr_hugepages
+  region = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+  if (region == MAP_FAILED) {
+    region = NULL;
+  } else {
+    *kind = SCS_PAGES_HUGETLB;
+  }
+#endif
+
+  if (!region) {
+    region = map_aligned(bytes);
+    if (!region) return NULL;
+    *kind = SCS_PAGES_NORMAL;
+#if defined(MADV_HUGEPAGE)
+    // Advise before the first touch so the faults allocate huge pages
+    if (madvise(region, bytes, MADV_HUGEPAGE) == 0) *kind = SCS_PAGES_TRANSPARENT;
+#endif
+  }
+
+  prefault(region, bytes);
+
+  if (lock) {
+    int saved = errno;
+    if (mlock(region, bytes) == 0) {
+      *locked = 1;
+      errno = saved;
+    }
+  }
+  return region;
+}
+
+void scs_region_unmap(void *region, size_t mapped) {
+  if (region) munmap(region, mapped);
+}
@@ -0,0 +1,187 @@
+//
+//  packet_ring.c
+//  SwiftConnectCli
+//
+//  TPACKET_V2 ring behind packet_ring.h
+//
+
+#include "packet_ring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(scs_bpf_insn) == sizeof(struct sock_filter), "scs_bpf_insn layout");
+
+static unsigned round_up_pow2(unsigned value) {
+  unsigned result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+int scs_packet_ring_open(scs_packet_ring *ring, const char *ifname, uint32_t snaplen,
+                         size_t ring_bytes, const scs_bpf_insn *filter, uint16_t filter_length) {
+  memset(ring, 0, sizeof *ring);
+  ring->fd = -1;
+
+  unsigned ifindex = if_nametoindex(ifname);
+  if (!ifindex) return -1;
+
+  // SOCK_DGRAM delivers packets from the network header, which is all a TUN
+  // has. Protocol 0 receives nothing until bind() names the protocol and the
+  // interface, so the outer DTLS/ESP traffic on other interfaces never lands
+  // in the ring while it is set up.
+  int fd = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+
+  int version = TPACKET_V2;
+  if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof version) < 0) goto fail;
+
+  // Attach the filter before binding so no unfiltered packet is queued either
+  if (filter && filter_length) {
+    struct sock_fprog program = {.len = filter_length, .filter = (struct sock_filter *)filter};
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof program) < 0) goto fail;
+  }
+
+  // Frames hold the header plus snaplen bytes; blocks hold whole frames
+  unsigned frame_size = round_up_pow2(TPACKET_ALIGN(TPACKET2_HDRLEN) + snaplen);
+  if (frame_size < TPACKET_ALIGNMENT * 128) frame_size = TPACKET_ALIGNMENT * 128;
+  unsigned block_size = frame_size < 65536 ? 65536 : frame_size;
+  unsigned block_count = (unsigned)(ring_bytes / block_size);
+  if (block_count < 1) block_count = 1;
+
+  struct tpacket_req request = {
+      .tp_block_size = block_size,
+      .tp_block_nr = block_count,
+      .tp_frame_size = frame_size,
+      .tp_frame_nr = block_count * (block_size / frame_size),
+  };
+  if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &request, sizeof request) < 0) goto fail;
+
+  size_t map_size = (size_t)block_size * block_count;
+  void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd, 0);
+  if (map == MAP_FAILED) {
+    // MAP_LOCKED can exceed RLIMIT_MEMLOCK; the ring still works unlocked
+    map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) goto fail;
+  }
+
+  // Delivery starts here, for this interface only
+  struct sockaddr_ll address = {
+      .sll_family = AF_PACKET,
+      .sll_protocol = htons(ETH_P_ALL),
+      .sll_ifindex = (int)ifindex,
+  };
+  if (bind(fd, (struct sockaddr *)&address, sizeof address) < 0) {
+    munmap(map, map_size);
+    goto fail;
+  }
+
+  ring->fd = fd;
+  ring->map = map;
+  ring->map_size = map_size;
+  ring->frame_size = frame_size;
+  ring->frame_count = request.tp_frame_nr;
+  return 0;
+
+fail : {
+  int saved = errno;
+  close(fd);
+  errno = saved;
+  return -1;
+}
+}
+
+static struct tpacket2_hdr *frame_at(scs_packet_ring *ring, unsigned index) {
+  return (struct tpacket2_hdr *)((uint8_t *)ring->map + (size_t)index * ring->frame_size);
+}
+
+int scs_packet_ring_next(scs_packet_ring *ring, scs_packet *packet) {
+  struct tpacket2_hdr *header = frame_at(ring, ring->next);
+  if (!(__atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) return 0;
+
+  packet->timestamp_ns = (uint64_t)header->tp_sec * 1000000000u + header->tp_nsec;
+  packet->captured_length = header->tp_snaplen;
+  packet->original_length = header->tp_len;
+  packet->data = (const uint8_t *)header + header->tp_net;
+  return 1;
+}
+
+void scs_packet_ring_release(scs_packet_ring *ring) {
+  struct tpacket2_hdr *header = frame_at(ring, ring->next);
+  __atomic_store_n(&header->tp_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  ring->next = (ring->next + 1) % ring->frame_count;
+}
+
+int scs_packet_ring_wait(scs_packet_ring *ring, int timeout_ms) {
+  struct pollfd descriptor = {.fd = ring->fd, .events = POLLIN};
+  int result = poll(&descriptor, 1, timeout_ms);
+  if (result > 0 && (descriptor.revents & (POLLERR | POLLNVAL))) {
+    // e.g. ENETDOWN once the interface goes away
+    int error = 0;
+    socklen_t length = sizeof error;
+    getsockopt(ring->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    errno = error ? error : EIO;
+    return -1;
+  }
+  return result;
+}
+
+void scs_packet_ring_stats(scs_packet_ring *ring, uint32_t *packets, uint32_t *drops) {
+  struct tpacket_stats stats = {0};
+  socklen_t length = sizeof stats;
+  getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, &stats, &length);
+  *packets = stats.tp_packets;
+  *drops = stats.tp_drops;
+}
+
+void scs_packet_ring_close(scs_packet_ring *ring) {
+  if (ring->map) munmap(ring->map, ring->map_size);
+  if (ring->fd >= 0) close(ring->fd);
+  memset(ring, 0, sizeof *ring);
+  ring->fd = -1;
+}
+
+#else
+
+int scs_packet_ring_open(scs_packet_ring *ring, const char *ifname, uint32_t snaplen,
+                         size_t ring_bytes, const scs_bpf_insn *filter, uint16_t filter_length) {
+  (void)ifname, (void)snaplen, (void)ring_bytes, (void)filter, (void)filter_length;
+  memset(ring, 0, sizeof *ring);
+  ring->fd = -1;
+  errno = ENOSYS;
+  return -1;
+}
+
+int scs_packet_ring_next(scs_packet_ring *ring, scs_packet *packet) {
+  (void)ring, (void)packet;
+  return 0;
+}
+
+void scs_packet_ring_release(scs_packet_ring *ring) { (void)ring; }
+
+int scs_packet_ring_wait(scs_packet_ring *ring, int timeout_ms) {
+  (void)ring, (void)timeout_ms;
+  return 0;
+}
+
+void scs_packet_ring_stats(scs_packet_ring *ring, uint32_t *packets, uint32_t *drops) {
+  (void)ring;
+  *packets = 0;
+  *drops = 0;
+}
+
+void scs_packet_ring_close(scs_packet_ring *ring) { (void)ring; }
+
+#endif
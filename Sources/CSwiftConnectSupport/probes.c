@@ -0,0 +1,24 @@
+//
+//  probes.c
+//  SwiftConnectCli
+//
+//  SDT semaphores for the probes declared in probes.h
+//
+
+#include "probes.h"
+
+#if SCS_HAVE_SDT
+// Tracers increment these in the .probes section when they attach
+#define SCS_DEFINE_SEMAPHORE(name) \
+  volatile unsigned short SCS_SEMAPHORE(name) __attribute__((section(".probes"), used)) = 0
+
+SCS_DEFINE_SEMAPHORE(status);
+SCS_DEFINE_SEMAPHORE(auth_begin);
+SCS_DEFINE_SEMAPHORE(auth_end);
+SCS_DEFINE_SEMAPHORE(reconnect);
+SCS_DEFINE_SEMAPHORE(stats);
+SCS_DEFINE_SEMAPHORE(forward_open);
+#elif defined(__linux__)
+// Reported here rather than in probes.h so it appears once per build
+#warning "<sys/sdt.h> not found: USDT probes are compiled out (install systemtap-sdt-dev)"
+#endif
@@ -0,0 +1,258 @@
+//
+//  profiler.c
+//  SwiftConnectCli
+//
+//  SIGPROF sampler behind profiler.h
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "profiler.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+static struct {
+  scs_profile_sample *samples;
+  size_t capacity;
+  size_t next;
+  int running;
+} profiler;
+
+// Stacks the unwinder may read, as [low, high) ranges sorted by address.
+// On Linux these are the writable anonymous mappings and [stack] at start;
+// a thread's stack is one of them (or a contiguous run of them).
+#define SCS_PROF_MAX_REGIONS 4096
+static struct {
+  uintptr_t low, high;
+} regions[SCS_PROF_MAX_REGIONS];
+static size_t region_count;
+
+static uint64_t current_thread_id(void) {
+#if defined(__linux__)
+  return (uint64_t)syscall(SYS_gettid);
+#elif defined(__APPLE__)
+  uint64_t id = 0;
+  pthread_threadid_np(NULL, &id);
+  return id;
+#else
+  return 0;
+#endif
+}
+
+// Interrupted pc, frame pointer and stack pointer from the signal context
+static int registers(void *context, uintptr_t *pc, uintptr_t *fp, uintptr_t *sp) {
+  ucontext_t *uc = context;
+#if defined(__linux__) && defined(__x86_64__)
+  *pc = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+  *fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+  *sp = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+#elif defined(__linux__) && defined(__aarch64__)
+  *pc = (uintptr_t)uc->uc_mcontext.pc;
+  *fp = (uintptr_t)uc->uc_mcontext.regs[29];
+  *sp = (uintptr_t)uc->uc_mcontext.sp;
+#elif defined(__APPLE__) && defined(__x86_64__)
+  *pc = (uintptr_t)uc->uc_mcontext->__ss.__rip;
+  *fp = (uintptr_t)uc->uc_mcontext->__ss.__rbp;
+  *sp = (uintptr_t)uc->uc_mcontext->__ss.__rsp;
+#elif defined(__APPLE__) && defined(__arm64__)
+  *pc = (uintptr_t)__darwin_arm_thread_state64_get_pc(uc->uc_mcontext->__ss);
+  *fp = (uintptr_t)__darwin_arm_thread_state64_get_fp(uc->uc_mcontext->__ss);
+  *sp = (uintptr_t)__darwin_arm_thread_state64_get_sp(uc->uc_mcontext->__ss);
+#else
+  (void)uc, (void)pc, (void)fp, (void)sp;
+  return -1;
+#endif
+  return 0;
+}
+
+#if defined(__linux__)
+// Snapshots the candidate stack mappings; runs before the timer is armed.
+static void load_regions(void) {
+  region_count = 0;
+  FILE *maps = fopen("/proc/self/maps", "r");
+  if (!maps) return;
+
+  char line[512];
+  while (region_count < SCS_PROF_MAX_REGIONS && fgets(line, sizeof line, maps)) {
+    unsigned long low, high;
+    char perms[5];
+    char path[256] = "";
+    if (sscanf(line, "%lx-%lx %4s %*s %*s %*s %255s", &low, &high, perms, path) < 3) continue;
+    if (perms[0] != 'r' || perms[1] != 'w') continue;
+    if (path[0] && strcmp(path, "[stack]") != 0) continue;
+
+    // Adjacent mappings are merged so a stack split in two stays one range
+    if (region_count > 0 && regions[region_count - 1].high == low) {
+      regions[region_count - 1].high = high;
+    } else {
+      regions[region_count].low = low;
+      regions[region_count].high = high;
+      region_count++;
+    }
+  }
+  fclose(maps);
+}
+#endif
+
+// Upper end of the stack holding `sp`, or 0 when it is not known. Only
+// addresses in [sp, high) are read while unwinding; an rbp used as a general
+// register elsewhere then ends the walk instead of faulting.
+static uintptr_t stack_high(uintptr_t sp) {
+#if defined(__APPLE__)
+  (void)regions, (void)region_count;
+  pthread_t self = pthread_self();
+  uintptr_t high = (uintptr_t)pthread_get_stackaddr_np(self);
+  size_t size = pthread_get_stacksize_np(self);
+  return sp < high && high - sp <= size ? high : 0;
+#else
+  size_t low = 0, high = region_count;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (sp < regions[middle].low) {
+      high = middle;
+    } else if (sp >= regions[middle].high) {
+      low = middle + 1;
+    } else {
+      return regions[middle].high;
+    }
+  }
+  return 0;
+#endif
+}
+
+static void on_sigprof(int signal_number, siginfo_t *info, void *context) {
+  (void)signal_number, (void)info;
+  int saved_errno = errno;
+
+  size_t index = __atomic_fetch_add(&profiler.next, 1, __ATOMIC_RELAXED);
+  uintptr_t pc, fp, sp;
+  if (index >= profiler.capacity || registers(context, &pc, &fp, &sp) != 0) {
+    errno = saved_errno;
+    return;
+  }
+
+  scs_profile_sample *sample = &profiler.samples[index];
+  sample->thread_id = current_thread_id();
+  uint32_t depth = 0;
+  sample->frames[depth++] = pc;
+
+  // Each frame record is {previous fp, return address}; stay on this
+  // thread's stack, which lies between sp and its top and is walked upwards
+  uintptr_t high = stack_high(sp);
+  while (depth < SCS_PROF_MAX_DEPTH && fp >= sp && high >= 2 * sizeof(uintptr_t) &&
+         fp <= high - 2 * sizeof(uintptr_t) && fp % sizeof(uintptr_t) == 0) {
+    const uintptr_t *frame = (const uintptr_t *)fp;
+    uintptr_t next = frame[0];
+    uintptr_t return_address = frame[1];
+    if (!return_address) break;
+    sample->frames[depth++] = return_address;
+    if (next <= fp || next - fp > SCS_PROF_MAX_FRAME) break;
+    fp = next;
+  }
+
+  __atomic_store_n(&sample->depth, depth, __ATOMIC_RELEASE);
+  errno = saved_errno;
+}
+
+// Releases the claim taken by scs_profiler_start() when it fails.
+static int abandon_start(void) {
+  int saved = errno;
+  __atomic_store_n(&profiler.running, 0, __ATOMIC_RELEASE);
+  errno = saved;
+  return -1;
+}
+
+int scs_profiler_start(unsigned frequency, size_t capacity) {
+  if (frequency == 0 || frequency > 10000 || capacity == 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  // Claimed before anything else is touched: a concurrent start must not
+  // free the buffer a running handler writes into
+  int idle = 0;
+  if (!__atomic_compare_exchange_n(
+          &profiler.running, &idle, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    errno = EBUSY;
+    return -1;
+  }
+
+  // The previous buffer is only freed here, after its handler is long gone
+  free(profiler.samples);
+  profiler.samples = calloc(capacity, sizeof(scs_profile_sample));
+  if (!profiler.samples) return abandon_start();
+  profiler.capacity = capacity;
+#if defined(__linux__)
+  load_regions();
+#endif
+  __atomic_store_n(&profiler.next, 0, __ATOMIC_RELEASE);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof action);
+  action.sa_sigaction = on_sigprof;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, NULL) != 0) return abandon_start();
+
+  long interval = 1000000L / (long)frequency;
+  struct itimerval timer = {
+      .it_interval = {.tv_sec = interval / 1000000, .tv_usec = (int)(interval % 1000000)},
+      .it_value = {.tv_sec = interval / 1000000, .tv_usec = (int)(interval % 1000000)},
+  };
+  if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+    int saved = errno;
+    signal(SIGPROF, SIG_IGN);
+    errno = saved;
+    return abandon_start();
+  }
+  return 0;
+}
+
+size_t scs_profiler_stop(size_t *dropped) {
+  if (!__atomic_load_n(&profiler.running, __ATOMIC_ACQUIRE)) {
+    if (dropped) *dropped = 0;
+    return 0;
+  }
+
+  struct itimerval off;
+  memset(&off, 0, sizeof off);
+  setitimer(ITIMER_PROF, &off, NULL);
+  // A signal already pending must not terminate the process
+  signal(SIGPROF, SIG_IGN);
+
+  // Let handlers that were already running on other threads finish
+  struct timespec grace = {.tv_sec = 0, .tv_nsec = 20 * 1000 * 1000};
+  nanosleep(&grace, NULL);
+
+  size_t taken = __atomic_load_n(&profiler.next, __ATOMIC_ACQUIRE);
+  size_t kept = taken < profiler.capacity ? taken : profiler.capacity;
+  if (dropped) *dropped = taken - kept;
+  __atomic_store_n(&profiler.running, 0, __ATOMIC_RELEASE);
+  return kept;
+}
+
+const scs_profile_sample *scs_profiler_samples(void) { return profiler.samples; }
+
+int scs_profiler_module(uint64_t address, const char **path, uint64_t *offset) {
+  Dl_info info;
+  if (!dladdr((const void *)(uintptr_t)address, &info) || !info.dli_fname) return -1;
+  *path = info.dli_fname;
+  *offset = address - (uint64_t)(uintptr_t)info.dli_fbase;
+  return 0;
+}
@@ -0,0 +1,94 @@
+//
+//  startup.c
+//  SwiftConnectCli
+//
+//  Process start and constructor timestamps behind startup.h
+//
+
+#include "startup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/time.h>
+#endif
+
+static uint64_t constructor_ns;
+
+static uint64_t clock_ns(clockid_t clock) {
+  struct timespec now;
+  clock_gettime(clock, &now);
+  return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+uint64_t scs_monotonic_ns(void) { return clock_ns(CLOCK_MONOTONIC); }
+
+__attribute__((constructor)) static void record_constructor(void) {
+  constructor_ns = scs_monotonic_ns();
+}
+
+uint64_t scs_startup_constructor_ns(void) { return constructor_ns; }
+
+// Exec time handed over by a harness as CLOCK_REALTIME nanoseconds taken
+// just before exec, or 0. Shells have no monotonic clock but `date +%s%N`
+// gives realtime in nanoseconds; it is converted using the two clocks' offset now.
+static uint64_t exec_ns_from_environment(void) {
+  const char *value = getenv(SCS_STARTUP_EXEC_ENV);
+  if (!value || !*value) return 0;
+  char *end;
+  unsigned long long realtime = strtoull(value, &end, 10);
+  if (*end != '\0' || realtime == 0) return 0;
+
+  uint64_t now_realtime = clock_ns(CLOCK_REALTIME);
+  uint64_t now = scs_monotonic_ns();
+  if (realtime > now_realtime) return 0;
+  uint64_t age = now_realtime - realtime;
+  return age < now ? now - age : 0;
+}
+
+uint64_t scs_startup_exec_ns(void) {
+  uint64_t handed_over = exec_ns_from_environment();
+  if (handed_over) return handed_over;
+
+#if defined(__linux__)
+  // Field 22 of /proc/self/stat is the start time in clock ticks after boot;
+  // the command name in field 2 may contain spaces, so parse after its ')'
+  char buffer[1024];
+  FILE *stat = fopen("/proc/self/stat", "r");
+  if (!stat) return 0;
+  size_t length = fread(buffer, 1, sizeof buffer - 1, stat);
+  fclose(stat);
+  buffer[length] = '\0';
+
+  const char *field = strrchr(buffer, ')');
+  if (!field) return 0;
+  for (int index = 2; index < 22 && field; index++) {
+    field = strchr(field + 1, ' ');
+  }
+  unsigned long long ticks;
+  if (!field || sscanf(field + 1, "%llu", &ticks) != 1) return 0;
+
+  long hz = sysconf(_SC_CLK_TCK);
+  if (hz <= 0) return 0;
+  uint64_t started_boottime = ticks * (1000000000ull / (uint64_t)hz);
+  uint64_t age = clock_ns(CLOCK_BOOTTIME) - started_boottime;
+#elif defined(__APPLE__)
+  struct kinfo_proc info;
+  size_t size = sizeof info;
+  int mib[4] = {CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid()};
+  if (sysctl(mib, 4, &info, &size, NULL, 0) != 0) return 0;
+  struct timeval started = info.kp_proc.p_starttime;
+  uint64_t started_realtime =
+      (uint64_t)started.tv_sec * 1000000000ull + (uint64_t)started.tv_usec * 1000ull;
+  uint64_t age = clock_ns(CLOCK_REALTIME) - started_realtime;
+#else
+  uint64_t age = UINT64_MAX;
+#endif
+  uint64_t now = scs_monotonic_ns();
+  return age < now ? now - age : 0;
+}
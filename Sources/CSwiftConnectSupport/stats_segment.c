@@ -0,0 +1,136 @@
+//
+//  stats_segment.c
+//  SwiftConnectCli
+//
+//  Shared-memory mapping and sequence lock behind stats_segment.h
+//
+
+#include "stats_segment.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void segment_name(char *name, size_t size, int pid) {
+  snprintf(name, size, "/swiftconnect-%d", pid);
+}
+
+scs_stats_segment *scs_stats_create(int pid) {
+  char name[64];
+  segment_name(name, sizeof name, pid);
+
+  // The name is predictable, so a segment left by anyone else (or by an
+  // earlier process with this pid) is removed and a fresh one created
+  // exclusively; never write into an object another user prepared
+  shm_unlink(name);
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) return NULL;
+
+  // Readable by monitoring agents running as other users, whatever the umask
+  if (fchown(fd, geteuid(), getegid()) != 0 || fchmod(fd, 0644) != 0) {
+    int saved = errno;
+    close(fd);
+    shm_unlink(name);
+    errno = saved;
+    return NULL;
+  }
+
+  if (ftruncate(fd, sizeof(scs_stats_segment)) != 0) {
+    int saved = errno;
+    close(fd);
+    shm_unlink(name);
+    errno = saved;
+    return NULL;
+  }
+
+  void *map = mmap(NULL, sizeof(scs_stats_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int saved = errno;
+  close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name);
+    errno = saved;
+    return NULL;
+  }
+
+  scs_stats_segment *segment = map;
+  segment->version = SCS_STATS_VERSION;
+  segment->size = sizeof(scs_stats_segment);
+  segment->pid = pid;
+  // Published last: readers ignore the segment until the magic is there
+  __atomic_store_n(&segment->magic, SCS_STATS_MAGIC, __ATOMIC_RELEASE);
+  return segment;
+}
+
+const scs_stats_segment *scs_stats_attach(int pid) {
+  char name[64];
+  segment_name(name, sizeof name, pid);
+
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) return NULL;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (size_t)info.st_size < offsetof(scs_stats_segment, sequence)) {
+    close(fd);
+    errno = EINVAL;
+    return NULL;
+  }
+
+  // A segment from an older writer may be shorter than the mapping;
+  // scs_stats_read() never touches bytes past its `size`
+  void *map = mmap(NULL, sizeof(scs_stats_segment), PROT_READ, MAP_SHARED, fd, 0);
+  int saved = errno;
+  close(fd);
+  if (map == MAP_FAILED) {
+    errno = saved;
+    return NULL;
+  }
+  return map;
+}
+
+void scs_stats_detach(const scs_stats_segment *segment) {
+  munmap((void *)segment, sizeof(scs_stats_segment));
+}
+
+void scs_stats_unlink(int pid) {
+  char name[64];
+  segment_name(name, sizeof name, pid);
+  shm_unlink(name);
+}
+
+void scs_stats_write_begin(scs_stats_segment *segment) {
+  uint64_t sequence = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&segment->sequence, sequence + 1, __ATOMIC_RELAXED);
+  // Field stores must not become visible before the sequence turns odd
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void scs_stats_write_end(scs_stats_segment *segment) {
+  uint64_t sequence = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&segment->sequence, sequence + 1, __ATOMIC_RELEASE);
+}
+
+int scs_stats_read(const scs_stats_segment *segment, scs_stats_segment *snapshot) {
+  if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) != SCS_STATS_MAGIC ||
+      segment->version != SCS_STATS_VERSION) {
+    errno = EPROTO;
+    return -1;
+  }
+
+  size_t size = segment->size < sizeof *snapshot ? segment->size : sizeof *snapshot;
+  for (int attempt = 0; attempt < 10000; attempt++) {
+    uint64_t before = __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE);
+    if (before & 1) continue;
+
+    memset(snapshot, 0, sizeof *snapshot);
+    memcpy(snapshot, segment, size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&segment->sequence, __ATOMIC_RELAXED) == before) return 0;
+  }
+  errno = EBUSY;
+  return -1;
+}
@@ -0,0 +1,249 @@
+//
+//  AuthRules.swift
+//  SwiftConnectCli
+//
+//  Rules file model for answering authentication forms without prompting
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// A set of rules that supply values for authentication form fields.
+///
+/// Rules are loaded from a JSON file and all regular expressions are compiled
+/// once at load time, so matching a form costs only the regex evaluation.
+///
+/// ```json
+/// {
+///   "rules": [
+///     {
+///       "title": "^Login",
+///       "retries": 0,
+///       "fields": [
+///         { "name": "username", "value": { "literal": "alice" } },
+///         { "label": "(?i)password", "value": { "env": "VPN_PASSWORD" } },
+///         { "label": "(?i)token", "value": { "totp": { "env": "VPN_TOTP_SECRET" } } },
+///         { "label": "(?i)group", "value": { "option": "Engineering" } }
+///       ]
+///     }
+///   ]
+/// }
+/// ```
+struct AuthRules {
+
+  /// A rule applies to every form whose title and message match its patterns.
+  ///
+  /// `retries` is how many times a value may be sent again when the same form
+  /// comes straight back, e.g. a gateway asking for what the portal accepted.
+  struct FormRule {
+    let title: Regex<AnyRegexOutput>?
+    let message: Regex<AnyRegexOutput>?
+    let retries: Int
+    let fields: [FieldRule]
+
+    func matches(title formTitle: String?, message formMessage: String?) -> Bool {
+      AuthRules.matches(title, formTitle) && AuthRules.matches(message, formMessage)
+    }
+  }
+
+  /// A field rule applies to every field whose label and name match its patterns.
+  struct FieldRule {
+    let label: Regex<AnyRegexOutput>?
+    let name: Regex<AnyRegexOutput>?
+    let value: ValueSource
+
+    func matches(label fieldLabel: String, name fieldName: String) -> Bool {
+      AuthRules.matches(label, fieldLabel) && AuthRules.matches(name, fieldName)
+    }
+  }
+
+  /// Where the value for a matched field comes from.
+  indirect enum ValueSource {
+    /// A fixed string from the rules file.
+    case literal(String)
+    /// The value of an environment variable.
+    case environment(String)
+    /// A secret from the platform credential store.
+    case credential(service: String, account: String)
+    /// A time-based one-time password derived from a base32 secret.
+    case totp(secret: ValueSource, digits: Int, period: Int)
+    /// The first option of a select field matching the pattern.
+    case option(Regex<AnyRegexOutput>)
+
+    /// Credential store entries this source reads.
+    var credentials: [(service: String, account: String)] {
+      switch self {
+      case .credential(let service, let account): return [(service, account)]
+      case .totp(let secret, _, _): return secret.credentials
+      case .literal, .environment, .option: return []
+      }
+    }
+
+    /// Short name used in timing traces; never includes the value itself.
+    var kind: String {
+      switch self {
+      case .literal: return "literal"
+      case .environment: return "env"
+      case .credential: return "credential"
+      case .totp: return "totp"
+      case .option: return "option"
+      }
+    }
+  }
+
+  /// Error thrown when a rules file cannot be loaded.
+  struct LoadError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  let rules: [FormRule]
+
+  /// Returns the first rule that applies to a form with the given title and message.
+  func rule(forTitle title: String?, message: String?) -> FormRule? {
+    rules.first { $0.matches(title: title, message: message) }
+  }
+
+  /// Credential store entries any rule may read, for looking them up early.
+  var credentials: [(service: String, account: String)] {
+    rules.flatMap { $0.fields }.flatMap { $0.value.credentials }
+  }
+
+  // A missing pattern matches anything; a present pattern requires a value.
+  private static func matches(_ pattern: Regex<AnyRegexOutput>?, _ value: String?) -> Bool {
+    guard let pattern else { return true }
+    guard let value else { return false }
+    return value.contains(pattern)
+  }
+}
+
+// MARK: - Loading
+
+extension AuthRules {
+
+  /// Loads and compiles the rules file at the given path.
+  static func load(contentsOf path: String) throws -> AuthRules {
+    let data: Data
+    do {
+      data = try Data(contentsOf: URL(fileURLWithPath: path))
+    } catch {
+      throw LoadError(description: "Cannot read auth rules file '\(path)': \(error)")
+    }
+
+    let file: RulesFile
+    do {
+      file = try JSONDecoder().decode(RulesFile.self, from: data)
+    } catch {
+      throw LoadError(description: "Invalid auth rules file '\(path)': \(error)")
+    }
+
+    return AuthRules(rules: try file.rules.map { try $0.compile() })
+  }
+
+  private static func compile(_ pattern: String?) throws -> Regex<AnyRegexOutput>? {
+    guard let pattern else { return nil }
+    do {
+      return try Regex(pattern)
+    } catch {
+      throw LoadError(description: "Invalid pattern '\(pattern)': \(error)")
+    }
+  }
+
+  // On-disk representation; compiled into the types above once loaded.
+
+  private struct RulesFile: Decodable {
+    let rules: [RawFormRule]
+  }
+
+  private struct RawFormRule: Decodable {
+    let title: String?
+    let message: String?
+    let retries: Int?
+    let fields: [RawFieldRule]
+
+    func compile() throws -> FormRule {
+      guard (retries ?? 0) >= 0 else {
+        throw LoadError(description: "\"retries\" must not be negative")
+      }
+      return FormRule(
+        title: try AuthRules.compile(title),
+        message: try AuthRules.compile(message),
+        retries: retries ?? 0,
+        fields: try fields.map { try $0.compile() }
+      )
+    }
+  }
+
+  private struct RawFieldRule: Decodable {
+    let label: String?
+    let name: String?
+    let value: RawValueSource
+
+    func compile() throws -> FieldRule {
+      FieldRule(
+        label: try AuthRules.compile(label),
+        name: try AuthRules.compile(name),
+        value: try value.compile()
+      )
+    }
+  }
+
+  private struct RawTotp: Decodable {
+    let digits: Int?
+    let period: Int?
+  }
+
+  private struct RawCredential: Decodable {
+    let service: String
+    let account: String
+  }
+
+  // Exactly one of the keys selects the source; "totp" nests another source
+  // for its secret alongside the optional "digits" and "period".
+  private struct RawValueSource: Decodable {
+    let literal: String?
+    let env: String?
+    let credential: RawCredential?
+    let totp: Box?
+    let option: String?
+
+    final class Box: Decodable {
+      let secret: RawValueSource
+      let parameters: RawTotp
+
+      init(from decoder: Decoder) throws {
+        secret = try RawValueSource(from: decoder)
+        parameters = try RawTotp(from: decoder)
+      }
+    }
+
+    func compile() throws -> ValueSource {
+      var sources: [ValueSource] = []
+      if let literal { sources.append(.literal(literal)) }
+      if let env { sources.append(.environment(env)) }
+      if let credential {
+        sources.append(.credential(service: credential.service, account: credential.account))
+      }
+      if let totp {
+        let digits = totp.parameters.digits ?? 6
+        let period = totp.parameters.period ?? 30
+        guard (6...8).contains(digits), period > 0 else {
+          throw LoadError(description: "TOTP requires 6-8 digits and a positive period")
+        }
+        sources.append(.totp(secret: try totp.secret.compile(), digits: digits, period: period))
+      }
+      if let option, let pattern = try AuthRules.compile(option) {
+        sources.append(.option(pattern))
+      }
+
+      guard sources.count == 1, let source = sources.first else {
+        throw LoadError(
+          description: "Each value must have exactly one of: literal, env, credential, totp, option"
+        )
+      }
+      return source
+    }
+  }
+}
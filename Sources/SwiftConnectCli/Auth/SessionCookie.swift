@@ -0,0 +1,144 @@
+//
+//  SessionCookie.swift
+//  SwiftConnectCli
+//
+//  Result of a completed authentication exchange, persisted between commands
+//
+
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Everything needed to bring up a tunnel without authenticating again.
+///
+/// Stored in the same `KEY='value'` form that `openconnect --authenticate`
+/// prints, so the file can also be sourced from a shell script.
+struct SessionCookie {
+  let cookie: String
+  let host: String
+  let fingerprint: String
+  let vpnProtocol: VpnProtocol
+  /// Server URL the cookie was issued for, with the resolved gateway as host.
+  let url: String
+
+  init(cookie: String, host: String, fingerprint: String, vpnProtocol: VpnProtocol, url: String) {
+    self.cookie = cookie
+    self.host = host
+    self.fingerprint = fingerprint
+    self.vpnProtocol = vpnProtocol
+    self.url = url
+  }
+
+  /// Cookie issued by `gateway` after authenticating against `server`.
+  ///
+  /// The URL keeps the scheme, port, path (which carries the usergroup) and
+  /// query of `server`; only the host is swapped for the gateway the exchange
+  /// ended at.
+  init(
+    cookie: String, gateway: String, fingerprint: String, vpnProtocol: VpnProtocol, server: URL
+  ) {
+    var url = "\(server.scheme ?? "https")://\(Self.urlHost(gateway))"
+    if let port = server.port {
+      url += ":\(port)"
+    }
+    url += server.path(percentEncoded: true)
+    if let query = server.query(percentEncoded: true) {
+      url += "?" + query
+    }
+    self.init(
+      cookie: cookie, host: gateway, fingerprint: fingerprint, vpnProtocol: vpnProtocol, url: url)
+  }
+
+  /// URL to connect to with the cookie.
+  var connectURL: URL? {
+    URL(string: url)
+  }
+
+  /// Error thrown when a cookie file cannot be read or parsed.
+  struct FileError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  // MARK: - Serialization
+
+  /// Shell-compatible representation of the cookie.
+  var serialized: String {
+    [
+      ("COOKIE", cookie),
+      ("HOST", host),
+      ("CONNECT_URL", url),
+      ("FINGERPRINT", fingerprint),
+      ("PROTOCOL", vpnProtocol.rawValue),
+    ]
+    .map { "\($0)=\(Shell.quote($1))\n" }
+    .joined()
+  }
+
+  /// Writes the cookie to `path` with owner-only permissions.
+  func write(to path: String) throws {
+    let fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0o600)
+    guard fd >= 0 else {
+      throw FileError(
+        description: "Cannot create cookie file '\(path)': \(String(cString: strerror(errno)))")
+    }
+    defer { close(fd) }
+
+    // O_CREAT does not change the mode of an existing file
+    fchmod(fd, 0o600)
+
+    let bytes = Array(serialized.utf8)
+    guard Sockets.writeAll(fd, bytes, bytes.count) else {
+      throw FileError(
+        description: "Cannot write cookie file '\(path)': \(String(cString: strerror(errno)))")
+    }
+  }
+
+  /// Reads a cookie previously written by `swiftconnect-cli authenticate`.
+  static func read(from path: String) throws -> SessionCookie {
+    guard let data = FileManager.default.contents(atPath: path),
+      let contents = String(data: data, encoding: .utf8)
+    else {
+      throw FileError(description: "Cannot read cookie file '\(path)'")
+    }
+
+    var values: [String: String] = [:]
+    for line in contents.split(whereSeparator: \.isNewline) {
+      guard let equals = line.firstIndex(of: "=") else { continue }
+      values[String(line[..<equals])] = Shell.unquote(line[line.index(after: equals)...])
+    }
+
+    guard let cookie = values["COOKIE"], let host = values["HOST"],
+      let fingerprint = values["FINGERPRINT"]
+    else {
+      throw FileError(
+        description: "Cookie file '\(path)' must contain COOKIE, HOST and FINGERPRINT")
+    }
+
+    let protocolName = values["PROTOCOL"] ?? "anyconnect"
+    guard let vpnProtocol = VpnProtocol(rawValue: protocolName) else {
+      throw FileError(description: "Cookie file '\(path)' has unknown protocol '\(protocolName)'")
+    }
+
+    // Files written before CONNECT_URL was stored only name the host
+    return SessionCookie(
+      cookie: cookie, host: host, fingerprint: fingerprint, vpnProtocol: vpnProtocol,
+      url: values["CONNECT_URL"] ?? "https://\(urlHost(host))")
+  }
+
+  // IPv6 literals need brackets in a URL
+  private static func urlHost(_ host: String) -> String {
+    host.contains(":") && !host.hasPrefix("[") ? "[\(host)]" : host
+  }
+}
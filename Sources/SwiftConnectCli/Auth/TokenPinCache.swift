@@ -0,0 +1,63 @@
+//
+//  TokenPinCache.swift
+//  SwiftConnectCli
+//
+//  Process-lifetime cache of hardware token PINs
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Remembers PINs entered for PKCS#11 tokens so reconnects never prompt again.
+///
+/// libopenconnect asks for a token PIN through an ordinary authentication form
+/// whose single password field is named `pkcs11_pin` and whose message names
+/// the token. A cached PIN is offered at most once between successful
+/// connections: if the token asks again before the tunnel comes up, the PIN
+/// was rejected and is evicted rather than replayed into a lockout.
+final class TokenPinCache: Sendable {
+
+  /// Name libopenconnect gives the password field of a token PIN form.
+  static let fieldName = "pkcs11_pin"
+
+  private struct Entry {
+    var pin: String
+    var offered: Bool
+  }
+
+  private let entries = Mutex<[String: Entry]>([:])
+
+  /// Returns the cached PIN for `token`, or nil if none is usable.
+  func pin(for token: String) -> String? {
+    entries.withLock { entries in
+      guard var entry = entries[token] else { return nil }
+      if entry.offered {
+        // Asked again before connecting: the cached PIN did not work
+        entries[token] = nil
+        return nil
+      }
+      entry.offered = true
+      entries[token] = entry
+      return entry.pin
+    }
+  }
+
+  /// Stores a PIN the user entered for `token`.
+  func store(_ pin: String, for token: String) {
+    entries.withLock { $0[token] = Entry(pin: pin, offered: true) }
+  }
+
+  /// Marks every offered PIN as accepted once the tunnel is up.
+  func confirmAll() {
+    entries.withLock { entries in
+      for token in entries.keys {
+        entries[token]?.offered = false
+      }
+    }
+  }
+}
@@ -0,0 +1,91 @@
+//
+//  CaptureController.swift
+//  SwiftConnectCli
+//
+//  The `capture` control command of a running session
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Starts and stops packet captures on behalf of control socket clients.
+///
+/// Requests are `start <path> <snaplen> <ring bytes> <filter>`, `stop` and
+/// `status`; a snap length of 0 means the interface MTU. At most one capture
+/// runs at a time.
+final class CaptureController: Sendable {
+
+  private let interface = Mutex<String?>(nil)
+  private let capture = Mutex<PacketCapture?>(nil)
+
+  /// Records the tunnel interface once it exists; nil while there is none.
+  func setInterface(_ name: String?) {
+    interface.withLock { $0 = name }
+  }
+
+  /// Control socket handler for the `capture` command.
+  func handle(_ arguments: [String]) throws -> String {
+    switch arguments.first {
+    case "start":
+      guard arguments.count == 5, let snaplen = UInt32(arguments[2]),
+        let ringBytes = Int(arguments[3])
+      else {
+        throw ControlServer.CommandError(description: "Usage: start PATH SNAPLEN RING_BYTES FILTER")
+      }
+      return try start(
+        PacketCapture.Settings(
+          path: arguments[1], snaplen: snaplen, ringBytes: ringBytes, filter: arguments[4]))
+
+    case "stop":
+      guard let running = capture.withLock({ $0.take() }) else {
+        throw ControlServer.CommandError(description: "No capture is running")
+      }
+      return "Stopped capture to \(running.settings.path): \(running.stop())"
+
+    case "status":
+      guard let running = capture.withLock({ $0 }) else {
+        return "Not capturing"
+      }
+      return "Capturing on \(running.interface) to \(running.settings.path): \(running.snapshot)"
+
+    default:
+      throw ControlServer.CommandError(description: "Usage: capture start|stop|status")
+    }
+  }
+
+  /// Stops a running capture so its file is complete before the process exits.
+  func stopAll() -> PacketCapture.Summary? {
+    capture.withLock { $0.take() }?.stop()
+  }
+
+  private func start(_ requested: PacketCapture.Settings) throws -> String {
+    guard let interface = interface.withLock({ $0 }) else {
+      throw ControlServer.CommandError(
+        description: "No tunnel interface to capture on (not connected, or using a userspace stack)")
+    }
+    var settings = requested
+    if settings.snaplen == 0 {
+      settings.snaplen = PacketCapture.snaplen(for: interface)
+    }
+
+    return try capture.withLock { capture in
+      if let running = capture {
+        throw ControlServer.CommandError(
+          description: "Already capturing to \(running.settings.path); stop it first")
+      }
+      do {
+        capture = try PacketCapture(interface: interface, settings: settings)
+      } catch {
+        throw ControlServer.CommandError(description: "\(error)")
+      }
+
+      let filter = settings.filter.isEmpty ? "all packets" : "'\(settings.filter)'"
+      return "Capturing \(filter) on \(interface) to \(settings.path) (snaplen \(settings.snaplen))"
+    }
+  }
+}
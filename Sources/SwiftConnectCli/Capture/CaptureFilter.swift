@@ -0,0 +1,369 @@
+//
+//  CaptureFilter.swift
+//  SwiftConnectCli
+//
+//  tcpdump-style filter expressions compiled to classic BPF
+//
+
+import CSwiftConnectSupport
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// A packet filter for captures on the tunnel interface.
+///
+/// Supports the subset of pcap-filter syntax that is useful on an IP-only
+/// link: `ip`, `ip6`, `tcp`, `udp`, `icmp`, `icmp6`, `[src|dst] host ADDR`
+/// and `[src|dst] port N`, combined with `and`, `or`, `not` and parentheses.
+/// The program runs in the kernel before a packet is copied into the ring;
+/// accepted packets are truncated to the snap length by its return value.
+struct CaptureFilter {
+
+  /// Error thrown for expressions outside the supported syntax.
+  struct ParseError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Which address or port of a packet a primitive looks at.
+  enum Direction {
+    case source, destination, either
+  }
+
+  indirect enum Expression {
+    case ipVersion(UInt32)
+    case transport(ipv4: UInt32, ipv6: UInt32)
+    case host([UInt8], Direction)
+    case port(UInt16, Direction)
+    case not(Expression)
+    case and(Expression, Expression)
+    case or(Expression, Expression)
+  }
+
+  /// The parsed expression; nil accepts every packet.
+  let expression: Expression?
+
+  init(_ text: String) throws {
+    let tokens = Self.tokenize(text)
+    guard !tokens.isEmpty else {
+      expression = nil
+      return
+    }
+    var parser = Parser(tokens: tokens)
+    expression = try parser.parseOr()
+    if let extra = parser.peek {
+      throw ParseError(description: "Unexpected '\(extra)' in filter")
+    }
+  }
+
+  // MARK: - Parsing
+
+  private static func tokenize(_ text: String) -> [String] {
+    var tokens: [String] = []
+    var current = ""
+    for character in text {
+      if character == "(" || character == ")" || character.isWhitespace {
+        if !current.isEmpty { tokens.append(current) }
+        current = ""
+        if !character.isWhitespace { tokens.append(String(character)) }
+      } else {
+        current.append(character)
+      }
+    }
+    if !current.isEmpty { tokens.append(current) }
+    return tokens
+  }
+
+  private struct Parser {
+    let tokens: [String]
+    var position = 0
+
+    var peek: String? {
+      position < tokens.count ? tokens[position] : nil
+    }
+
+    mutating func next() throws -> String {
+      guard let token = peek else {
+        throw ParseError(description: "Filter ends unexpectedly")
+      }
+      position += 1
+      return token
+    }
+
+    mutating func accept(_ keyword: String) -> Bool {
+      guard peek == keyword else { return false }
+      position += 1
+      return true
+    }
+
+    mutating func parseOr() throws -> Expression {
+      var result = try parseAnd()
+      while accept("or") || accept("||") {
+        result = .or(result, try parseAnd())
+      }
+      return result
+    }
+
+    mutating func parseAnd() throws -> Expression {
+      var result = try parseUnary()
+      while accept("and") || accept("&&") {
+        result = .and(result, try parseUnary())
+      }
+      return result
+    }
+
+    mutating func parseUnary() throws -> Expression {
+      if accept("not") || accept("!") {
+        return .not(try parseUnary())
+      }
+      if accept("(") {
+        let inner = try parseOr()
+        guard accept(")") else { throw ParseError(description: "Missing ')' in filter") }
+        return inner
+      }
+      return try parsePrimitive()
+    }
+
+    mutating func parsePrimitive() throws -> Expression {
+      var direction = Direction.either
+      if accept("src") {
+        direction = .source
+      } else if accept("dst") {
+        direction = .destination
+      }
+
+      let keyword = try next()
+      switch keyword {
+      case "host":
+        let text = try next()
+        guard let address = CaptureFilter.parseAddress(text) else {
+          throw ParseError(description: "Invalid address '\(text)' in filter")
+        }
+        return .host(address, direction)
+
+      case "port":
+        let text = try next()
+        guard let port = UInt16(text) else {
+          throw ParseError(description: "Invalid port '\(text)' in filter")
+        }
+        return .port(port, direction)
+
+      case _ where direction != .either:
+        throw ParseError(description: "Expected 'host' or 'port' after direction, found '\(keyword)'")
+      case "ip": return .ipVersion(4)
+      case "ip6": return .ipVersion(6)
+      case "tcp": return .transport(ipv4: 6, ipv6: 6)
+      case "udp": return .transport(ipv4: 17, ipv6: 17)
+      case "icmp": return .and(.ipVersion(4), .transport(ipv4: 1, ipv6: 1))
+      case "icmp6": return .and(.ipVersion(6), .transport(ipv4: 58, ipv6: 58))
+      default:
+        throw ParseError(description: "Unknown filter keyword '\(keyword)'")
+      }
+    }
+  }
+
+  private static func parseAddress(_ text: String) -> [UInt8]? {
+    var ipv4 = in_addr()
+    if inet_pton(AF_INET, text, &ipv4) == 1 {
+      return withUnsafeBytes(of: &ipv4) { Array($0) }
+    }
+    var ipv6 = in6_addr()
+    if inet_pton(AF_INET6, text, &ipv6) == 1 {
+      return withUnsafeBytes(of: &ipv6) { Array($0) }
+    }
+    return nil
+  }
+
+  // MARK: - Compilation
+
+  /// Compiles the filter into a program accepting `snaplen` bytes of a match.
+  func program(snaplen: UInt32) throws -> [scs_bpf_insn] {
+    var assembler = Assembler()
+    let accept = assembler.makeLabel()
+    let reject = assembler.makeLabel()
+
+    if let expression {
+      assembler.emit(lowered(expression), onTrue: accept, onFalse: reject)
+    }
+    assembler.place(accept)
+    assembler.append(BPF.ret, k: snaplen)
+    assembler.place(reject)
+    assembler.append(BPF.ret, k: 0)
+    return try assembler.resolved()
+  }
+
+  // Packets start at the IP header: the version is in the top nibble of byte
+  // 0; IPv4 has its protocol at 9 and addresses at 12/16, IPv6 its next
+  // header at 6 and addresses at 8/24. IPv6 ports assume no extension headers.
+  private func lowered(_ expression: Expression) -> Test {
+    switch expression {
+    case .ipVersion(let version):
+      return .masked(offset: 0, mask: 0xf0, value: version << 4)
+
+    case .transport(let ipv4, let ipv6):
+      return .or(
+        .and(.masked(offset: 0, mask: 0xf0, value: 0x40), .byte(offset: 9, value: ipv4)),
+        .and(.masked(offset: 0, mask: 0xf0, value: 0x60), .byte(offset: 6, value: ipv6)))
+
+    case .host(let address, let direction):
+      let isIPv4 = address.count == 4
+      let offsets = isIPv4 ? (source: 12, destination: 16) : (source: 8, destination: 24)
+      let matches = { (offset: Int) -> Test in
+        stride(from: 0, to: address.count, by: 4)
+          .map { index -> Test in
+            let word = address[index..<index + 4].reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+            return .word(offset: UInt32(offset + index), value: word)
+          }
+          .reduce(nil) { (result: Test?, test: Test) in result.map { .and($0, test) } ?? test }!
+      }
+      let version: Test = .masked(offset: 0, mask: 0xf0, value: isIPv4 ? 0x40 : 0x60)
+      switch direction {
+      case .source: return .and(version, matches(offsets.source))
+      case .destination: return .and(version, matches(offsets.destination))
+      case .either: return .and(version, .or(matches(offsets.source), matches(offsets.destination)))
+      }
+
+    case .port(let port, let direction):
+      let value = UInt32(port)
+      let ipv4Ports: Test
+      let ipv6Ports: Test
+      switch direction {
+      case .source:
+        ipv4Ports = .transportHalf(offset: 0, value: value)
+        ipv6Ports = .half(offset: 40, value: value)
+      case .destination:
+        ipv4Ports = .transportHalf(offset: 2, value: value)
+        ipv6Ports = .half(offset: 42, value: value)
+      case .either:
+        ipv4Ports = .or(.transportHalf(offset: 0, value: value), .transportHalf(offset: 2, value: value))
+        ipv6Ports = .or(.half(offset: 40, value: value), .half(offset: 42, value: value))
+      }
+      let tcpOrUdp = { (offset: UInt32) -> Test in
+        .or(.byte(offset: offset, value: 6), .byte(offset: offset, value: 17))
+      }
+      return .or(
+        .and(
+          .and(.masked(offset: 0, mask: 0xf0, value: 0x40), tcpOrUdp(9)),
+          .and(.firstFragment, ipv4Ports)),
+        .and(.and(.masked(offset: 0, mask: 0xf0, value: 0x60), tcpOrUdp(6)), ipv6Ports))
+
+    case .not(let inner):
+      return .not(lowered(inner))
+    case .and(let left, let right):
+      return .and(lowered(left), lowered(right))
+    case .or(let left, let right):
+      return .or(lowered(left), lowered(right))
+    }
+  }
+
+  // Conditions that map onto a load and a single conditional jump
+  private indirect enum Test {
+    case byte(offset: UInt32, value: UInt32)
+    case half(offset: UInt32, value: UInt32)
+    case word(offset: UInt32, value: UInt32)
+    case masked(offset: UInt32, mask: UInt32, value: UInt32)
+    // Halfword at `offset` past the variable-length IPv4 header
+    case transportHalf(offset: UInt32, value: UInt32)
+    // IPv4 fragment offset is zero, so the transport header is present
+    case firstFragment
+    case not(Test)
+    case and(Test, Test)
+    case or(Test, Test)
+  }
+
+  private enum BPF {
+    static let ldAbsWord: UInt16 = 0x20
+    static let ldAbsHalf: UInt16 = 0x28
+    static let ldAbsByte: UInt16 = 0x30
+    static let ldIndHalf: UInt16 = 0x48
+    static let ldxMsh: UInt16 = 0xb1
+    static let andK: UInt16 = 0x54
+    static let jeqK: UInt16 = 0x15
+    static let jsetK: UInt16 = 0x45
+    static let ret: UInt16 = 0x06
+  }
+
+  // Emits forward-only jumps to labels and patches their offsets at the end
+  private struct Assembler {
+    typealias Label = Int
+
+    private var instructions: [(code: UInt16, k: UInt32, jt: Label?, jf: Label?)] = []
+    private var labels: [Int?] = []
+
+    mutating func makeLabel() -> Label {
+      labels.append(nil)
+      return labels.count - 1
+    }
+
+    mutating func place(_ label: Label) {
+      labels[label] = instructions.count
+    }
+
+    mutating func append(_ code: UInt16, k: UInt32, jt: Label? = nil, jf: Label? = nil) {
+      instructions.append((code, k, jt, jf))
+    }
+
+    mutating func emit(_ test: Test, onTrue: Label, onFalse: Label) {
+      switch test {
+      case .byte(let offset, let value):
+        append(BPF.ldAbsByte, k: offset)
+        append(BPF.jeqK, k: value, jt: onTrue, jf: onFalse)
+      case .half(let offset, let value):
+        append(BPF.ldAbsHalf, k: offset)
+        append(BPF.jeqK, k: value, jt: onTrue, jf: onFalse)
+      case .word(let offset, let value):
+        append(BPF.ldAbsWord, k: offset)
+        append(BPF.jeqK, k: value, jt: onTrue, jf: onFalse)
+      case .masked(let offset, let mask, let value):
+        append(BPF.ldAbsByte, k: offset)
+        append(BPF.andK, k: mask)
+        append(BPF.jeqK, k: value, jt: onTrue, jf: onFalse)
+      case .transportHalf(let offset, let value):
+        append(BPF.ldxMsh, k: 0)
+        append(BPF.ldIndHalf, k: offset)
+        append(BPF.jeqK, k: value, jt: onTrue, jf: onFalse)
+      case .firstFragment:
+        append(BPF.ldAbsHalf, k: 6)
+        append(BPF.jsetK, k: 0x1fff, jt: onFalse, jf: onTrue)
+      case .not(let inner):
+        emit(inner, onTrue: onFalse, onFalse: onTrue)
+      case .and(let left, let right):
+        let next = makeLabel()
+        emit(left, onTrue: next, onFalse: onFalse)
+        place(next)
+        emit(right, onTrue: onTrue, onFalse: onFalse)
+      case .or(let left, let right):
+        let next = makeLabel()
+        emit(left, onTrue: onTrue, onFalse: next)
+        place(next)
+        emit(right, onTrue: onTrue, onFalse: onFalse)
+      }
+    }
+
+    // Jump offsets count instructions after the jump and must fit a byte
+    func resolved() throws -> [scs_bpf_insn] {
+      try instructions.enumerated().map { index, instruction in
+        let offset = { (label: Label?) throws -> UInt8 in
+          guard let label, let target = labels[label] else { return 0 }
+          guard let offset = UInt8(exactly: target - index - 1) else {
+            throw ParseError(description: "Filter is too long")
+          }
+          return offset
+        }
+        return scs_bpf_insn(
+          code: instruction.code, jt: try offset(instruction.jt), jf: try offset(instruction.jf),
+          k: instruction.k)
+      }
+    }
+  }
+}
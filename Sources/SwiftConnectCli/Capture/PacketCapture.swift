@@ -0,0 +1,194 @@
+//
+//  PacketCapture.swift
+//  SwiftConnectCli
+//
+//  Streams packets from the tunnel interface's receive ring to pcapng
+//
+
+import CSwiftConnectSupport
+import Dispatch
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// One running capture on the tunnel interface.
+///
+/// The kernel filters and truncates each packet and places it in a
+/// memory-mapped ring allocated when the capture starts; a dedicated thread
+/// drains the ring into a ``PcapngWriter``. Both directions are captured.
+/// When no capture is running there is no socket, no ring and no thread.
+final class PacketCapture: Sendable {
+
+  /// Error thrown when the capture cannot be started.
+  struct StartError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Settings requested by the client.
+  struct Settings {
+    var path: String
+    var snaplen: UInt32
+    var ringBytes: Int
+    var filter: String
+  }
+
+  /// Counters reported by `capture status` and `capture stop`.
+  struct Summary: CustomStringConvertible {
+    var packets: UInt64 = 0
+    var bytes: UInt64 = 0
+    var drops: UInt64 = 0
+    var error: String?
+
+    var description: String {
+      var text = "\(packets) packets (\(Units.bytes(bytes))) written, \(drops) dropped"
+      if let error {
+        text += "; stopped early: \(error)"
+      }
+      return text
+    }
+  }
+
+  /// Largest snap length used by default; bigger ones only cost ring space.
+  static let maximumSnaplen: UInt32 = 65_535
+
+  let settings: Settings
+  let interface: String
+
+  private let summary = Mutex(Summary())
+  private let stopRequested = Atomic<Bool>(false)
+  private let finished = DispatchSemaphore(value: 0)
+
+  // The ring and writer belong to the capture thread once it has started
+  private final class Resources: @unchecked Sendable {
+    var ring: scs_packet_ring
+    let writer: PcapngWriter
+
+    init(ring: scs_packet_ring, writer: PcapngWriter) {
+      self.ring = ring
+      self.writer = writer
+    }
+  }
+
+  /// Opens the ring and the output file and starts draining.
+  init(interface: String, settings: Settings) throws {
+    self.interface = interface
+    self.settings = settings
+
+    let program: [scs_bpf_insn]
+    do {
+      program = try CaptureFilter(settings.filter).program(snaplen: settings.snaplen)
+    } catch {
+      throw StartError(description: "\(error)")
+    }
+
+    var ring = scs_packet_ring()
+    let opened = program.withUnsafeBufferPointer { program in
+      scs_packet_ring_open(
+        &ring, interface, settings.snaplen, settings.ringBytes, program.baseAddress,
+        UInt16(program.count))
+    }
+    guard opened == 0 else {
+      throw StartError(
+        description: "Cannot capture on \(interface): \(String(cString: strerror(errno)))")
+    }
+
+    let writer: PcapngWriter
+    do {
+      writer = try PcapngWriter(path: settings.path, interface: interface, snaplen: settings.snaplen)
+    } catch {
+      scs_packet_ring_close(&ring)
+      throw StartError(description: "\(error)")
+    }
+
+    let resources = Resources(ring: ring, writer: writer)
+    Threads.detach(name: "capture") { [self] in
+      drain(resources)
+      finished.signal()
+    }
+  }
+
+  /// Default snap length: the interface MTU, which holds a whole packet.
+  ///
+  /// TPACKET_V2 frames have a fixed size of header plus snap length rounded
+  /// up to a power of two, so a generous snap length shrinks the ring to a
+  /// handful of frames (an 8 MiB ring holds 16 frames at 256 KiB).
+  static func snaplen(for interface: String) -> UInt32 {
+    #if os(Linux)
+      if let text = try? String(contentsOfFile: "/sys/class/net/\(interface)/mtu", encoding: .utf8),
+        let mtu = UInt32(text.filter(\.isNumber)), mtu > 0
+      {
+        return min(mtu, maximumSnaplen)
+      }
+    #endif
+    return maximumSnaplen
+  }
+
+  /// Current counters.
+  var snapshot: Summary {
+    summary.withLock { $0 }
+  }
+
+  /// Stops the capture, waits for buffered packets to be written and returns
+  /// the final counters.
+  func stop() -> Summary {
+    if !stopRequested.exchange(true, ordering: .acquiringAndReleasing) {
+      finished.wait()
+    }
+    return snapshot
+  }
+
+  // MARK: - Draining
+
+  private func drain(_ resources: Resources) {
+    defer { scs_packet_ring_close(&resources.ring) }
+
+    var packet = scs_packet()
+    while !stopRequested.load(ordering: .acquiring) {
+      // Short timeout so stop requests are noticed promptly
+      guard scs_packet_ring_wait(&resources.ring, 200) >= 0 || errno == EINTR else {
+        let reason = String(cString: strerror(errno))
+        summary.withLock { $0.error = reason }
+        break
+      }
+
+      var packets: UInt64 = 0
+      var bytes: UInt64 = 0
+      while scs_packet_ring_next(&resources.ring, &packet) == 1 {
+        resources.writer.write(
+          timestampNanoseconds: packet.timestamp_ns,
+          data: UnsafeRawBufferPointer(
+            start: packet.data, count: Int(packet.captured_length)),
+          originalLength: packet.original_length)
+        scs_packet_ring_release(&resources.ring)
+        packets += 1
+        bytes += UInt64(packet.captured_length)
+      }
+
+      if packets > 0 {
+        resources.writer.flush()
+      }
+      var received: UInt32 = 0
+      var dropped: UInt32 = 0
+      scs_packet_ring_stats(&resources.ring, &received, &dropped)
+      summary.withLock {
+        $0.packets += packets
+        $0.bytes += bytes
+        $0.drops += UInt64(dropped)
+      }
+    }
+
+    resources.writer.flush()
+  }
+}
@@ -0,0 +1,127 @@
+//
+//  PcapngWriter.swift
+//  SwiftConnectCli
+//
+//  Minimal pcapng file writer for raw IP packets
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Writes a pcapng section with a single raw-IP interface.
+///
+/// Timestamps are stored with nanosecond resolution (`if_tsresol` 9), so the
+/// ring's kernel timestamps are kept unchanged. Output is buffered by stdio;
+/// call ``flush()`` to make packets visible to a reader following the file.
+final class PcapngWriter {
+
+  /// Error thrown when the file cannot be created.
+  struct WriteError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// LINKTYPE_RAW: packets begin with an IPv4 or IPv6 header.
+  static let linkTypeRaw: UInt16 = 101
+
+  private let file: UnsafeMutablePointer<FILE>
+  private var block: [UInt8] = []
+
+  init(path: String, interface: String, snaplen: UInt32) throws {
+    let fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0o600)
+    guard fd >= 0, let file = fdopen(fd, "wb") else {
+      throw WriteError(
+        description: "Cannot create '\(path)': \(String(cString: strerror(errno)))")
+    }
+    self.file = file
+    block.reserveCapacity(64 * 1024)
+
+    // Section header block, section length unknown
+    begin(type: 0x0A0D_0D0A)
+    append32(0x1A2B_3C4D)
+    append16(1)
+    append16(0)
+    append64(UInt64.max)
+    finish()
+
+    // Interface description block with if_name and if_tsresol
+    begin(type: 1)
+    append16(Self.linkTypeRaw)
+    append16(0)
+    append32(snaplen)
+    appendOption(code: 2, Array(interface.utf8))
+    appendOption(code: 9, [9])
+    appendOption(code: 0, [])
+    finish()
+  }
+
+  deinit {
+    fclose(file)
+  }
+
+  /// Appends one packet as an enhanced packet block on interface 0.
+  func write(timestampNanoseconds: UInt64, data: UnsafeRawBufferPointer, originalLength: UInt32) {
+    begin(type: 6)
+    append32(0)
+    append32(UInt32(truncatingIfNeeded: timestampNanoseconds >> 32))
+    append32(UInt32(truncatingIfNeeded: timestampNanoseconds))
+    append32(UInt32(data.count))
+    append32(originalLength)
+    block.append(contentsOf: data)
+    pad()
+    finish()
+  }
+
+  func flush() {
+    fflush(file)
+  }
+
+  // MARK: - Blocks
+
+  // Blocks are type, total length, body, total length; the length is patched in finish()
+  private func begin(type: UInt32) {
+    block.removeAll(keepingCapacity: true)
+    append32(type)
+    append32(0)
+  }
+
+  private func finish() {
+    let length = UInt32(block.count + 4)
+    append32(length)
+    withUnsafeBytes(of: length.littleEndian) { block.replaceSubrange(4..<8, with: $0) }
+    _ = block.withUnsafeBytes { fwrite($0.baseAddress, 1, $0.count, file) }
+  }
+
+  private func appendOption(code: UInt16, _ value: [UInt8]) {
+    append16(code)
+    append16(UInt16(value.count))
+    block.append(contentsOf: value)
+    pad()
+  }
+
+  private func pad() {
+    while block.count % 4 != 0 { block.append(0) }
+  }
+
+  private func append16(_ value: UInt16) {
+    withUnsafeBytes(of: value.littleEndian) { block.append(contentsOf: $0) }
+  }
+
+  private func append32(_ value: UInt32) {
+    withUnsafeBytes(of: value.littleEndian) { block.append(contentsOf: $0) }
+  }
+
+  private func append64(_ value: UInt64) {
+    withUnsafeBytes(of: value.littleEndian) { block.append(contentsOf: $0) }
+  }
+}
@@ -6,8 +6,22 @@
 //
 
 import ArgumentParser
-import Foundation
 import OpenConnectKit
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
 
 @main
 struct Cli: ParsableCommand {
@@ -20,175 +34,92 @@ struct Cli: ParsableCommand {
       Pulse Secure, and others.
 
       Note: This application requires elevated privileges (root/Administrator)
-      to create network interfaces and modify routing tables.
+      to create network interfaces and modify routing tables, unless the tunnel
+      is exposed as a local proxy with --proxy-listen or --http-proxy-listen.
       """,
-    version: "1.0.0"
+    version: "1.0.0",
+    subcommands: [
+      Connect.self, Authenticate.self, Status.self, Top.self, History.self, Capture.self,
+      Profile.self, LogDecode.self,
+    ],
+    defaultSubcommand: Connect.self
   )
 
-  @Argument(help: "VPN server URL (e.g., https://vpn.example.com)")
-  var server: String?
+  static func main() {
+    // Start-up phases are measured from exec; this is the first Swift code run
+    StartupMetrics.mark("main")
 
-  @Argument(help: "Username for authentication (optional, will prompt if not provided)")
-  var username: String?
-
-  @Option(name: .long, help: "VPN protocol (anyconnect, gp, pulse, nc, array)")
-  var vpnProtocol: String = "anyconnect"
-
-  @Flag(name: .shortAndLong, help: "Increase verbosity (-v: info, -vv: debug, -vvv: trace)")
-  var verbose: Int
-
-  mutating func run() throws {
-    // Check for elevated privileges first
-    do {
-      try PrivilegeChecker.requireElevatedPrivileges()
-    } catch {
-      throw ExitCode.failure
-    }
-
-    // Validate server URL
-    guard let server else {
-      print("\n❌ Error: Server URL is required")
-      print("\nUsage: swiftconnect-cli <server-url> [username]\n")
-      print("Example: swiftconnect-cli https://vpn.example.com myuser")
-      throw ExitCode.validationFailure
+    // Redirected to a file or pipe, stdout would be fully buffered and status
+    // lines would show up kilobytes late; scripts and log shippers wait on them
+    if isatty(STDOUT_FILENO) == 0 {
+      setvbuf(stdout, nil, _IOLBF, 0)
     }
+    main(nil)
+  }
+}
 
-    guard let serverURL = URL(string: server) else {
-      print("\n❌ Error: Invalid server URL: '\(server)'")
-      print("\nThe server URL must be a valid URL, including the protocol.")
-      print("Example: https://vpn.example.com")
-      throw ExitCode.validationFailure
-    }
-
-    // Parse VPN protocol
-    guard let vpnProtocol = VpnProtocol(rawValue: vpnProtocol) else {
-      print("\n❌ Error: Invalid VPN protocol '\(vpnProtocol)'")
-      print("\nSupported protocols:")
-      print("  • anyconnect - Cisco AnyConnect")
-      print("  • gp         - GlobalProtect (Palo Alto)")
-      print("  • pulse      - Pulse Secure")
-      print("  • nc         - Juniper Network Connect")
-      print("  • array      - Array Networks")
-      throw ExitCode.validationFailure
-    }
-
-    // Convert CLI verbosity count to LogLevel
-    let logLevel: LogLevel
-    switch verbose {
-    case 0: logLevel = .error  // No -v flag: errors only
-    case 1: logLevel = .info  // -v: info level
-    case 2: logLevel = .debug  // -vv: debug level
-    default: logLevel = .trace  // -vvv or more: trace level
-    }
-
-    // Create configuration
-    let config = VpnConfiguration(
-      serverURL: serverURL,
-      vpnProtocol: vpnProtocol,
-      logLevel: logLevel,
-      allowInsecureCertificates: false
-    )
-
-    print("\n" + String(repeating: "=", count: 60))
-    print("SwiftConnect CLI - OpenConnect VPN Client")
-    print(String(repeating: "=", count: 60))
-    print("\nConfiguration:")
-    print("  Server:   \(serverURL)")
-    print("  Protocol: \(vpnProtocol.rawValue)")
-    print("  Log Level: \(logLevel)")
-    print()
+// MARK: - VPN Session Delegate Handler
 
-    // Create delegate handler
-    let handler = CliVpnHandler()
+/// Handles VPN session events for the CLI application
+final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
 
-    // Create VPN session with delegate
-    let session = VpnSession(configuration: config, delegate: handler)
+  /// Rules used to answer form fields before prompting, if configured
+  private let autoAnswer: AuthAutoAnswer?
 
-    // Set optional logging delegate
-    session.loggingDelegate = handler
+  /// CLI verbosity count; timing traces are printed from -v upwards
+  private let verbose: Int
 
-    print("Connecting to VPN...\n")
+  /// Most verbose level printed; the session may log more for the flight recorder
+  private let printLevel: LogLevel
 
-    // Connect to VPN
-    do {
-      try session.connect()
-      print("\n✅ Connection initiated successfully!")
-      print(String(repeating: "=", count: 60))
-      print()
+  /// Token PINs entered this process, replayed on reconnect
+  private let tokenPins = TokenPinCache()
 
-      // Note: Interface name will be displayed when status changes to .connected
-      // after TUN device setup completes (see onStatusChanged callback)
+  /// Port forwards whose counters are included in the statistics output
+  var portForwarders: [PortForwarder] = []
 
-      // Keep the connection alive
-      print("Press Ctrl+C to disconnect...")
-      print()
+  /// When set, log lines go to this file unformatted instead of the terminal
+  var binaryLog: BinaryLog?
 
-      // Set up signal handlers for graceful disconnect.
-      // Suppress default signal behaviour so we can handle it ourselves.
-      signal(SIGINT, SIG_IGN)
-      signal(SIGTERM, SIG_IGN)
+  /// Serves `capture` requests; told about the tunnel interface once it exists
+  var captureController: CaptureController?
 
-      let sigintSource = DispatchSource.makeSignalSource(signal: SIGINT, queue: .main)
-      sigintSource.setEventHandler {
-        print("\n\nDisconnecting...")
-        session.disconnect()
-      }
-      sigintSource.resume()
+  /// Reconnects since the session started, reported by the reconnect probe
+  private var reconnectCount = 0
 
-      let sigtermSource = DispatchSource.makeSignalSource(signal: SIGTERM, queue: .main)
-      sigtermSource.setEventHandler {
-        print("\n\nDisconnecting...")
-        session.disconnect()
-      }
-      sigtermSource.resume()
+  /// Reads the tunnel interface's counters; attached once the tunnel is up
+  var trafficMonitor: TrafficMonitor?
 
-      // Start periodic stats updates
-      startPeriodicStats(session: session)
+  /// Receives every reported sample when --history-file is set
+  var history: HistoryStore?
 
-      // Block on main dispatch queue
-      dispatchMain()
+  /// Sample the last statistics block was printed for
+  private var lastReported: TrafficSample?
 
-    } catch let error as VpnError {
-      print("\n" + String(repeating: "=", count: 60))
-      print("❌ Connection failed: \(error.localizedDescription)")
-      print(String(repeating: "=", count: 60))
-      print()
-      throw ExitCode.failure
-    } catch {
-      print("\n" + String(repeating: "=", count: 60))
-      print("❌ Unexpected error: \(error)")
-      print(String(repeating: "=", count: 60))
-      print()
-      throw ExitCode.failure
-    }
-  }
+  /// Own resource use when the last statistics block was printed
+  private var lastResources: ResourceUsage?
 
-  // MARK: - Connection Monitoring
+  /// Serializes `report`: the report timer runs it on the main queue and
+  /// `didReceiveStats` on the session thread, and both update the state above
+  private let reportLock = Mutex(())
 
-  private func startPeriodicStats(session: VpnSession) {
-    // Request stats every 10 seconds on a background queue
-    let timer = DispatchSource.makeTimerSource(queue: .global())
-    timer.schedule(deadline: .now(), repeating: .seconds(10))
-    timer.setEventHandler {
-      session.requestStats()
-    }
-    timer.resume()
+  init(autoAnswer: AuthAutoAnswer? = nil, verbose: Int = 0, printLevel: LogLevel = .trace) {
+    self.autoAnswer = autoAnswer
+    self.verbose = verbose
+    self.printLevel = printLevel
   }
-}
-
-// MARK: - VPN Session Delegate Handler
-
-/// Handles VPN session events for the CLI application
-final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
 
   // MARK: - VpnSessionDelegate
 
   func vpnSession(_ session: VpnSession, didChangeStatus status: ConnectionStatus) {
-    let timestamp = DateFormatter.localizedString(
-      from: Date(),
-      dateStyle: .none,
-      timeStyle: .medium
-    )
+    if case .reconnecting = status {
+      reconnectCount += 1
+    }
+    Probes.status(status)
+    FlightRecorder.record(event: "status \(status)")
+    StatsSegment.publish(status: status, reconnects: reconnectCount)
+
+    let timestamp = Timestamp.time()
 
     switch status {
     case .disconnecting:
@@ -197,8 +128,8 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
     case .disconnected(let error):
       print("\n" + String(repeating: "=", count: 60))
       if let error = error {
-        print("❌ Disconnected: \(error.localizedDescription)")
-        print("[\(timestamp)] ❌ Status: Disconnected - \(error.localizedDescription)")
+        print("❌ Disconnected: \(error.message)")
+        print("[\(timestamp)] ❌ Status: Disconnected - \(error.message)")
       } else {
         print("✅ Disconnected")
         print("[\(timestamp)] ℹ️  Status: Disconnected")
@@ -206,20 +137,37 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
       print(String(repeating: "=", count: 60))
       print()
 
+      // Keep the trace leading up to the failure
+      if error != nil, let path = FlightRecorder.dump(reason: "disconnect") {
+        print("📼 Flight recording written to \(path)")
+        print()
+      }
+
       // Exit the program after disconnect
-      Foundation.exit(0)
+      if let summary = captureController?.stopAll() {
+        print("📦 Capture stopped: \(summary)")
+      }
+      binaryLog?.close()
+      Posix.exit(0)
 
     case .connecting(let stage):
       print("[\(timestamp)] 🔄 Status: \(stage)")
 
     case .connected:
+      tokenPins.confirmAll()
+      autoAnswer?.confirmAll()
       print("[\(timestamp)] ✅ Status: Connected!")
       // Display interface name now that TUN setup is complete
       if let ifname = session.interfaceName {
         print("[\(timestamp)] 🌐 Network Interface: \(ifname)")
       }
+      captureController?.setInterface(session.interfaceName)
+      StatsSegment.publish(interface: session.interfaceName)
+      trafficMonitor?.attach(interface: session.interfaceName)
+      StartupMetrics.reportConnected(monitor: trafficMonitor)
 
     case .reconnecting:
+      Probes.reconnect(count: reconnectCount)
       print("\n" + String(repeating: "=", count: 60))
       print("🔄 VPN connection reconnecting after connection loss...")
       print(String(repeating: "=", count: 60))
@@ -231,6 +179,11 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
   func vpnSession(_ session: VpnSession, requiresAuthentication form: AuthenticationForm)
     -> AuthenticationForm
   {
+    let clock = ContinuousClock()
+    let started = clock.now
+    Probes.authBegin(title: form.title, fields: form.fields.count)
+    FlightRecorder.record(event: "auth form '\(form.title ?? "")' with \(form.fields.count) field(s)")
+
     print("\n" + String(repeating: "=", count: 60))
     print("🔐 Authentication Required")
     print(String(repeating: "=", count: 60))
@@ -245,20 +198,50 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
 
     var filledForm = form
 
-    // Fill in form fields by prompting user
-    for (index, field) in filledForm.fields.enumerated() {
+    // Answer what the rules can, then prompt for the rest
+    var answered = Set<Int>()
+    if let autoAnswer {
+      let result = autoAnswer.fill(&filledForm)
+      answered = result.answered
+
+      for field in result.trace.fields {
+        if let failure = field.failure {
+          print("⚠️  Warning: Rule for '\(field.label)' failed: \(failure)")
+        }
+      }
+      if verbose > 0 && result.trace.matchedRule {
+        print("⏱  Auto-answered \(result.trace.summary)")
+      }
+    }
+
+    // Fill in remaining form fields by prompting user
+    var prompted = 0
+    for (index, field) in filledForm.fields.enumerated() where !answered.contains(index) {
       switch field.type {
       case .password:
+        // Hardware token PINs are asked for once per process
+        let isTokenPin = field.name == TokenPinCache.fieldName
+        let token = form.message ?? field.label
+        if isTokenPin, let pin = tokenPins.pin(for: token) {
+          filledForm.fields[index].value = pin
+          continue
+        }
+
         // Use secure input for password fields
+        prompted += 1
         print("\(field.label)")
         if let password = SecureInput.read(prompt: "> ") {
           filledForm.fields[index].value = password
+          if isTokenPin {
+            tokenPins.store(password, for: token)
+          }
         } else {
           print("⚠️  Warning: Empty password entered")
           filledForm.fields[index].value = ""
         }
 
       case .text:
+        prompted += 1
         print("\(field.label)")
         print("> ", terminator: "")
         if let input = readLine() {
@@ -270,6 +253,7 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
         continue
 
       case .select(let options):
+        prompted += 1
         print("\n\(field.label)")
         for (idx, option) in options.enumerated() {
           print("  \(idx + 1). \(option)")
@@ -284,6 +268,8 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
     }
 
     print()
+    Probes.authEnd(
+      duration: started.duration(to: clock.now), answered: answered.count, prompted: prompted)
     return filledForm
   }
 
@@ -310,37 +296,105 @@ final class CliVpnHandler: VpnSessionDelegate, VpnSessionLoggingDelegate {
   // MARK: - VpnSessionLoggingDelegate
 
   func vpnSession(_ session: VpnSession, didLog message: String, level: LogLevel) {
-    let timestamp = DateFormatter.localizedString(
-      from: Date(),
-      dateStyle: .none,
-      timeStyle: .medium
-    )
+    FlightRecorder.record(log: message, level: level)
+    guard level.rank <= printLevel.rank else { return }
 
-    let prefix: String
-    switch level {
-    case .error:
-      prefix = "ERROR"
-    case .info:
-      prefix = "INFO"
-    case .debug:
-      prefix = "DEBUG"
-    case .trace:
-      prefix = "TRACE"
+    if let binaryLog {
+      binaryLog.write(message, level: level)
+      return
     }
 
-    print("[\(timestamp)] \(prefix): \(message)")
+    let timestamp = Timestamp.time()
+
+    print("[\(timestamp)] \(level.label): \(message)")
   }
 
   func vpnSession(_ session: VpnSession, didReceiveStats stats: VpnStats) {
-    let timestamp = DateFormatter.localizedString(
-      from: Date(),
-      dateStyle: .none,
-      timeStyle: .medium
+    let sample = TrafficSample(
+      time: .now,
+      rxBytes: UInt64(stats.rxBytes),
+      txBytes: UInt64(stats.txBytes),
+      rxPackets: UInt64(stats.rxPackets),
+      txPackets: UInt64(stats.txPackets)
+    )
+    StatsSegment.publish(sample)
+    report(sample)
+  }
+
+  // MARK: - Statistics
+
+  /// Prints the statistics block for a counter sample, with rates since the
+  /// previously reported one. Safe to call from any thread.
+  func report(_ sample: TrafficSample) {
+    reportLock.withLock { _ in reportLocked(sample) }
+  }
+
+  private func reportLocked(_ sample: TrafficSample) {
+    let timestamp = Timestamp.time()
+
+    Probes.stats(
+      rxBytes: sample.rxBytes,
+      txBytes: sample.txBytes,
+      rxPackets: sample.rxPackets,
+      txPackets: sample.txPackets
     )
 
+    FlightRecorder.record(
+      event: "stats rx \(sample.rxBytes) B/\(sample.rxPackets) pkts tx \(sample.txBytes) B/\(sample.txPackets) pkts")
+
+    var txRate = ""
+    var rxRate = ""
+    var movedBytes: UInt64?
+    if let previous = lastReported, sample.time > previous.time,
+      sample.txBytes >= previous.txBytes, sample.rxBytes >= previous.rxBytes
+    {
+      let elapsed = Units.seconds(previous.time.duration(to: sample.time))
+      txRate = ", " + Units.bitRate(bytesPerSecond: Double(sample.txBytes - previous.txBytes) / elapsed)
+      rxRate = ", " + Units.bitRate(bytesPerSecond: Double(sample.rxBytes - previous.rxBytes) / elapsed)
+      movedBytes = (sample.txBytes - previous.txBytes) + (sample.rxBytes - previous.rxBytes)
+    }
+    lastReported = sample
+    history?.append(sample, rtt: GatewayProbe.latest)
+
     print("[\(timestamp)] 📊 Statistics:")
-    print("  ↑ TX: \(stats.formattedTxBytes) (\(stats.txPackets) packets)")
-    print("  ↓ RX: \(stats.formattedRxBytes) (\(stats.rxPackets) packets)")
-    print("  ∑ Total: \(stats.formattedTotalBytes)")
+    print("  ↑ TX: \(Units.bytes(sample.txBytes)) (\(sample.txPackets) packets)\(txRate)")
+    print("  ↓ RX: \(Units.bytes(sample.rxBytes)) (\(sample.rxPackets) packets)\(rxRate)")
+    print("  ∑ Total: \(Units.bytes(sample.txBytes + sample.rxBytes))")
+
+    // The CLI's own cost, so efficiency regressions show: CPU per Gbit moved
+    // and wakeups while idle
+    let resources = ResourceUsage.sample()
+    StatsSegment.publish(resources)
+    if let previous = lastResources, let rates = ResourceRates(from: previous, to: resources) {
+      var line =
+        "  ⚙ Process: CPU \(Units.decimal(rates.cpu * 100, places: 1))%, "
+        + "\(Units.decimal(rates.wakeupsPerSecond, places: 0)) wakeups/s, "
+        + "\(Units.decimal(rates.faultsPerSecond, places: 0)) faults/s, "
+        + "RSS \(Units.bytes(resources.residentBytes)), heap \(Units.bytes(resources.heapBytes))"
+      if let movedBytes, movedBytes > 0 {
+        let gigabits = Double(movedBytes) * 8 / 1e9
+        line += ", \(Units.decimal(Units.seconds(rates.cpuTime) / gigabits, places: 2)) CPU-s/Gbit"
+      }
+      print(line)
+
+      if verbose > 0 {
+        for thread in rates.threads.prefix(6) {
+          print(
+            "      \(thread.name): CPU \(Units.decimal(thread.cpu * 100, places: 1))%, "
+              + "\(Units.decimal(thread.wakeupsPerSecond, places: 0)) wakeups/s")
+        }
+      }
+    }
+    lastResources = resources
+
+    for forwarder in portForwarders {
+      let forward = forwarder.snapshot
+      print("  ⇄ \(forwarder.spec): ↑ \(Units.bytes(forward.bytesOut)) ↓ \(Units.bytes(forward.bytesIn))")
+      print(
+        "      \(forward.connections) connections (\(forward.active) active, \(forward.failed) failed), "
+          + "connect avg \(Units.milliseconds(forward.averageConnectLatency)) "
+          + "max \(Units.milliseconds(forward.connectLatencyMax))"
+      )
+    }
   }
 }
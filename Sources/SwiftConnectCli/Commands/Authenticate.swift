@@ -0,0 +1,123 @@
+//
+//  Authenticate.swift
+//  SwiftConnectCli
+//
+//  Performs only the authentication exchange and emits a reusable cookie
+//
+
+import ArgumentParser
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct Authenticate: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Authenticate without connecting and emit a session cookie",
+      discussion: """
+        Runs the authentication exchange only and prints the session cookie,
+        server certificate fingerprint and resolved gateway host. Pass the result
+        to 'swiftconnect-cli connect --cookie-file' to bring the tunnel up later
+        without authenticating again.
+
+        Only the KEY='value' lines go to standard output; progress, prompts and
+        logs go to standard error, so the output can be evaluated by a shell:
+          eval "$(swiftconnect-cli authenticate vpn.example.com)"
+
+        No network interfaces are created, so elevated privileges are not required.
+        """
+    )
+
+    @OptionGroup var options: ConnectionOptions
+
+    @Option(name: .long, help: "Write the cookie to this file (mode 0600) instead of stdout")
+    var cookieFile: String?
+
+    mutating func run() throws {
+      // Everything printed goes to stderr; the cookie is written to the
+      // original stdout at the end
+      fflush(stdout)
+      let output = dup(STDOUT_FILENO)
+      dup2(STDERR_FILENO, STDOUT_FILENO)
+      defer { Posix.close(output) }
+
+      let serverURL = try options.serverURL()
+      let vpnProtocol = try options.parsedProtocol()
+      let autoAnswer = try options.loadAutoAnswer()
+
+      var config = VpnConfiguration(
+        serverURL: serverURL,
+        vpnProtocol: vpnProtocol,
+        logLevel: options.logLevel,
+        allowInsecureCertificates: false
+      )
+      try options.applyClientCertificate(to: &config)
+
+      options.printBanner(serverURL: serverURL, vpnProtocol: vpnProtocol)
+      print()
+
+      let handler = CliVpnHandler(autoAnswer: autoAnswer, verbose: options.verbose)
+      let session = VpnSession(configuration: config, delegate: handler)
+      session.loggingDelegate = handler
+
+      print("Authenticating...\n")
+
+      let cookie: SessionCookie
+      do {
+        let result = try session.authenticate()
+        cookie = SessionCookie(
+          cookie: result.cookie,
+          gateway: result.host,
+          fingerprint: result.serverCertificateHash,
+          vpnProtocol: vpnProtocol,
+          server: serverURL
+        )
+      } catch let error as VpnError {
+        print("\n" + String(repeating: "=", count: 60))
+        print("❌ Authentication failed: \(error.message)")
+        print(String(repeating: "=", count: 60))
+        print()
+        throw ExitCode.failure
+      } catch {
+        print("\n" + String(repeating: "=", count: 60))
+        print("❌ Unexpected error: \(error)")
+        print(String(repeating: "=", count: 60))
+        print()
+        throw ExitCode.failure
+      }
+
+      print("\n✅ Authenticated with \(cookie.host)")
+      print(String(repeating: "=", count: 60))
+
+      if let cookieFile {
+        do {
+          try cookie.write(to: cookieFile)
+        } catch {
+          print("\n❌ Error: \(error)")
+          throw ExitCode.failure
+        }
+        print("Cookie written to \(cookieFile)")
+      } else {
+        fflush(stdout)
+        let bytes = Array(cookie.serialized.utf8)
+        guard Sockets.writeAll(output, bytes, bytes.count) else {
+          print("\n❌ Error: Cannot write cookie: \(String(cString: strerror(errno)))")
+          throw ExitCode.failure
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,106 @@
+//
+//  Capture.swift
+//  SwiftConnectCli
+//
+//  Controls packet capture inside a running session
+//
+
+import ArgumentParser
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct Capture: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Capture tunnel packets of a running session to a pcapng file",
+      discussion: """
+        The session captures from its own tunnel interface through a memory-mapped
+        ring, so no tcpdump is needed. The filter uses pcap-filter syntax limited to
+        ip, ip6, tcp, udp, icmp, icmp6, [src|dst] host and [src|dst] port, combined
+        with and, or, not and parentheses. The file is created by the session's user
+        with owner-only permissions.
+
+        Examples:
+          swiftconnect-cli capture start -w vpn.pcapng tcp port 443
+          swiftconnect-cli capture status
+          swiftconnect-cli capture stop
+        """
+    )
+
+    enum Action: String, ExpressibleByArgument, CaseIterable {
+      case start, stop, status
+    }
+
+    @Argument(help: "start, stop or status")
+    var action: Action
+
+    @Option(name: [.customShort("w"), .long], help: "pcapng file to write (start)")
+    var file: String?
+
+    @Option(
+      name: [.customShort("s"), .long], help: "Bytes kept of each packet (default: the tunnel's MTU)")
+    var snaplen: UInt32?
+
+    @Option(name: .long, help: "Capture ring size in MiB")
+    var ringSize: Int = 8
+
+    @Option(name: .long, help: "Process id of the session (needed when several are running)")
+    var pid: Int32?
+
+    @Argument(parsing: .remaining, help: "Filter expression (start)")
+    var filter: [String] = []
+
+    mutating func validate() throws {
+      if action == .start {
+        guard file != nil else {
+          throw ValidationError("capture start needs an output file (-w)")
+        }
+        guard snaplen != 0, ringSize > 0 else {
+          throw ValidationError("--snaplen and --ring-size must be positive")
+        }
+      } else if !filter.isEmpty || file != nil {
+        throw ValidationError("Only 'capture start' takes a file and filter")
+      }
+    }
+
+    mutating func run() throws {
+      var arguments = [action.rawValue]
+      if action == .start, let file {
+        // The session resolves paths against its own working directory
+        let path = URL(fileURLWithPath: file).path
+        let filter = filter.joined(separator: " ")
+
+        // Report syntax errors here rather than from the session
+        do {
+          _ = try CaptureFilter(filter).program(snaplen: snaplen ?? PacketCapture.maximumSnaplen)
+        } catch {
+          print("❌ Error: \(error)")
+          throw ExitCode.validationFailure
+        }
+        // 0 lets the session pick the interface MTU
+        arguments += [path, String(snaplen ?? 0), String(ringSize * 1024 * 1024), filter]
+      }
+
+      do {
+        let output = try ControlClient.send("capture", arguments, pid: pid)
+        print("📦 \(output)")
+      } catch {
+        print("❌ Error: \(error)")
+        throw ExitCode.failure
+      }
+    }
+  }
+}
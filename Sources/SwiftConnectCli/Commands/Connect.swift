@@ -0,0 +1,381 @@
+//
+//  Connect.swift
+//  SwiftConnectCli
+//
+//  Establishes a VPN tunnel and keeps it running until interrupted
+//
+
+import ArgumentParser
+import Dispatch
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct Connect: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Connect to a VPN server (default)",
+      discussion: """
+        Authenticates with the server and brings up the tunnel. With --cookie-file,
+        the cookie from a previous 'swiftconnect-cli authenticate' is used instead,
+        skipping authentication entirely.
+        """
+    )
+
+    @OptionGroup var options: ConnectionOptions
+
+    @OptionGroup var tunnel: TunnelOptions
+
+    @OptionGroup var diagnostics: DiagnosticsOptions
+
+    @Option(name: .long, help: "Connect with a cookie file from 'swiftconnect-cli authenticate'")
+    var cookieFile: String?
+
+    mutating func run() throws {
+      StartupMetrics.mark("parsed")
+      if diagnostics.startupTrace {
+        StartupMetrics.enableTrace()
+      }
+
+      // A userspace stack needs no TUN device, routes or DNS changes
+      let userspaceStack = try tunnel.userspaceStack()
+      let portForwarders = try userspaceStack.map { try tunnel.portForwarders(through: $0) } ?? []
+
+      // Check for elevated privileges first
+      if userspaceStack == nil {
+        do {
+          try PrivilegeChecker.requireElevatedPrivileges()
+        } catch {
+          throw ExitCode.failure
+        }
+      }
+
+      // A cookie file supplies the resolved gateway and protocol; otherwise they
+      // come from the command line
+      var cookie: SessionCookie?
+      if let cookieFile {
+        do {
+          cookie = try SessionCookie.read(from: cookieFile)
+        } catch {
+          print("\n❌ Error: \(error)")
+          throw ExitCode.validationFailure
+        }
+      }
+
+      let serverURL: URL
+      let vpnProtocol: VpnProtocol
+      if let cookie {
+        guard let connectURL = cookie.connectURL else {
+          print("\n❌ Error: Invalid URL in cookie file: '\(cookie.url)'")
+          throw ExitCode.validationFailure
+        }
+        serverURL = connectURL
+        vpnProtocol = cookie.vpnProtocol
+      } else {
+        serverURL = try options.serverURL()
+        vpnProtocol = try options.parsedProtocol()
+      }
+
+      // Start-up work that does not feed the configuration runs alongside
+      // building it. The gateway probe resolves the gateway straight away,
+      // which warms the resolver cache before libopenconnect connects; RTT
+      // handshakes only follow with --gateway-rtt.
+      do {
+        try StatsSegment.start(server: serverURL.host ?? serverURL.absoluteString)
+      } catch {
+        print("⚠️  Warning: \(error)")
+      }
+      if let host = serverURL.host {
+        GatewayProbe.start(
+          host: host, port: UInt16(serverURL.port ?? 443), interval: diagnostics.gatewayRttInterval)
+      }
+
+      let logLevel = options.logLevel
+      let autoAnswer = try options.loadAutoAnswer()
+
+      // Keychain and credential file lookups finish before the first form arrives
+      if let autoAnswer {
+        CredentialStore.prefetch(autoAnswer.rules.credentials)
+      }
+
+      // The flight recorder keeps debug logs whatever is printed, and trace
+      // logs with --flight-recorder-trace
+      diagnostics.startFlightRecorder()
+      let binaryLog = try diagnostics.openBinaryLog()
+      let history = try diagnostics.openHistory()
+
+      // Create configuration
+      var config = VpnConfiguration(
+        serverURL: serverURL,
+        vpnProtocol: vpnProtocol,
+        logLevel: diagnostics.sessionLogLevel(printing: logLevel),
+        allowInsecureCertificates: false
+      )
+      try options.applyClientCertificate(to: &config)
+      if let userspaceStack {
+        config.tunScript = userspaceStack.tunScript
+      }
+      if let vpncScript = try tunnel.vpncScriptPath(usingUserspaceStack: userspaceStack != nil) {
+        config.vpncScript = vpncScript
+      }
+
+      StartupMetrics.mark("configured")
+
+      options.printBanner(serverURL: serverURL, vpnProtocol: vpnProtocol)
+      if let cookieFile {
+        print("  Cookie:   \(cookieFile)")
+      }
+      if let userspaceStack, tunnel.proxyListen != nil || tunnel.httpProxyListen != nil {
+        print("  Proxy:    \(userspaceStack.endpoints.joined(separator: ", "))")
+      }
+      for forwarder in portForwarders {
+        print("  Forward:  \(forwarder.spec)")
+      }
+      if let binaryLog = diagnostics.binaryLog {
+        print("  Binary Log: \(binaryLog)")
+      }
+      if let historyFile = diagnostics.historyFile {
+        print("  History:  \(historyFile)")
+      }
+      if let netns = tunnel.netns {
+        print("  Namespace: \(netns)")
+      }
+      if let routeTable = tunnel.routeTable {
+        print("  Routing:  table \(routeTable)")
+      }
+      print()
+
+      // Create delegate handler
+      let handler = CliVpnHandler(
+        autoAnswer: autoAnswer, verbose: options.verbose, printLevel: logLevel)
+      handler.binaryLog = binaryLog
+      handler.history = history
+      handler.portForwarders = portForwarders
+      let trafficMonitor = TrafficMonitor()
+      handler.trafficMonitor = trafficMonitor
+
+      // The control socket serves 'swiftconnect-cli capture' and 'profile';
+      // the session works without it
+      let captureController = CaptureController()
+      handler.captureController = captureController
+      ControlServer.register("capture") { try captureController.handle($0) }
+      ControlServer.register("profile") { try Profiler.handle($0) }
+      do {
+        try ControlServer.start()
+      } catch {
+        print("⚠️  Warning: Control socket unavailable: \(error)")
+      }
+
+      // Bind every forward before connecting, so a bad --forward fails before
+      // any tunnel exists
+      for forwarder in portForwarders {
+        do {
+          try forwarder.openListener()
+        } catch {
+          print("❌ Error: Cannot listen for forward \(forwarder.spec): \(error)")
+          throw ExitCode.failure
+        }
+      }
+
+      // Create VPN session with delegate
+      let session = VpnSession(configuration: config, delegate: handler)
+      StartupMetrics.mark("session")
+
+      // Set optional logging delegate
+      session.loggingDelegate = handler
+
+      print("Connecting to VPN...\n")
+
+      // Connect to VPN
+      do {
+        if let cookie {
+          // Pinning the fingerprint from the authentication run keeps the
+          // certificate check without prompting again
+          try session.connect(cookie: cookie.cookie, serverCertificateHash: cookie.fingerprint)
+        } else {
+          try session.connect()
+        }
+        StartupMetrics.mark("connect-returned")
+        print("\n✅ Connection initiated successfully!")
+        print(String(repeating: "=", count: 60))
+        print()
+
+        // Note: Interface name will be displayed when status changes to .connected
+        // after TUN device setup completes (see onStatusChanged callback)
+
+        // Keep the connection alive
+        print("Press Ctrl+C to disconnect...")
+        print()
+
+        // Forwards accept from now on; connections opened before the tunnel
+        // is up fail at the SOCKS handshake and are closed
+        signal(SIGPIPE, SIG_IGN)
+        for forwarder in portForwarders {
+          forwarder.start()
+        }
+
+        // Set up signal handlers for graceful disconnect.
+        // Suppress default signal behaviour so we can handle it ourselves.
+        signal(SIGINT, SIG_IGN)
+        signal(SIGTERM, SIG_IGN)
+
+        let sigintSource = DispatchSource.makeSignalSource(signal: SIGINT, queue: .main)
+        sigintSource.setEventHandler {
+          print("\n\nDisconnecting...")
+          session.disconnect()
+        }
+        sigintSource.resume()
+
+        let sigtermSource = DispatchSource.makeSignalSource(signal: SIGTERM, queue: .main)
+        sigtermSource.setEventHandler {
+          print("\n\nDisconnecting...")
+          session.disconnect()
+        }
+        sigtermSource.resume()
+
+        // SIGUSR1 writes the flight recorder window without disturbing the session
+        signal(SIGUSR1, SIG_IGN)
+        let sigusr1Source = DispatchSource.makeSignalSource(signal: SIGUSR1, queue: .main)
+        sigusr1Source.setEventHandler {
+          if let path = FlightRecorder.dump(reason: "sigusr1") {
+            print("📼 Flight recording written to \(path)")
+          }
+        }
+        sigusr1Source.resume()
+
+        // SIGUSR2 profiles the session for ten seconds, next to the recordings
+        signal(SIGUSR2, SIG_IGN)
+        let profileDirectory = diagnostics.flightRecorderDirectory
+        let sigusr2Source = DispatchSource.makeSignalSource(signal: SIGUSR2, queue: .main)
+        sigusr2Source.setEventHandler {
+          Threads.detach(name: "profile") {
+            do {
+              let summary = try Profiler.run(
+                duration: .seconds(10), frequency: Profiler.defaultFrequency,
+                path: Profiler.path(in: profileDirectory))
+              print("🔥 \(summary)")
+            } catch {
+              print("⚠️  Warning: \(error)")
+            }
+          }
+        }
+        sigusr2Source.resume()
+
+        // Start periodic stats updates
+        let statsTimer = startPeriodicStats(
+          session: session, handler: handler, monitor: trafficMonitor)
+
+        // Block on main dispatch queue; sources are cancelled when released
+        withExtendedLifetime(
+          (sigintSource, sigtermSource, sigusr1Source, sigusr2Source, statsTimer)
+        ) {
+          dispatchMain()
+        }
+
+      } catch let error as VpnError {
+        print("\n" + String(repeating: "=", count: 60))
+        print("❌ Connection failed: \(error.message)")
+        print(String(repeating: "=", count: 60))
+        print()
+        throw ExitCode.failure
+      } catch {
+        print("\n" + String(repeating: "=", count: 60))
+        print("❌ Unexpected error: \(error)")
+        print(String(repeating: "=", count: 60))
+        print()
+        throw ExitCode.failure
+      }
+    }
+
+    // MARK: - Connection Monitoring
+
+    // Counters are read from the TUN device's sysfs files rather than kept by
+    // the data path. Without a device in this namespace (userspace stack,
+    // --netns) the session is asked for statistics instead.
+    private func startPeriodicStats(
+      session: VpnSession, handler: CliVpnHandler, monitor: TrafficMonitor
+    ) -> StatsTimer {
+      StatsTimer(session: session, handler: handler, monitor: monitor)
+    }
+  }
+}
+
+// MARK: - Stats Timer
+
+/// One timer that publishes traffic counters and prints the periodic report.
+///
+/// While traffic flows it fires every second, publishing each sample and
+/// reporting every tenth. Once a tick sees no new packets it backs off to the
+/// report interval, so an idle session wakes once per report.
+private final class StatsTimer {
+  private static let activeSeconds = 1
+  private static let idleSeconds = 10
+
+  private let timer = DispatchSource.makeTimerSource(queue: .main)
+  private let session: VpnSession
+  private let handler: CliVpnHandler
+  private let monitor: TrafficMonitor
+
+  private var interval = activeSeconds
+  private var lastSample: TrafficSample?
+  private var lastReport: ContinuousClock.Instant?
+
+  init(session: VpnSession, handler: CliVpnHandler, monitor: TrafficMonitor) {
+    self.session = session
+    self.handler = handler
+    self.monitor = monitor
+
+    timer.setEventHandler { [unowned self] in tick() }
+    timer.schedule(deadline: .now(), repeating: .seconds(interval), leeway: .milliseconds(100))
+    timer.resume()
+  }
+
+  deinit {
+    timer.cancel()
+  }
+
+  private func tick() {
+    guard let sample = monitor.sample() else {
+      session.requestStats()
+      reschedule(Self.idleSeconds)
+      return
+    }
+    StatsSegment.publish(sample)
+
+    // Half a tick of slack so timer leeway never pushes a report a tick late
+    let reportDue = lastReport.map {
+      sample.time - $0 >= .seconds(Self.idleSeconds) - .milliseconds(500)
+    }
+    if reportDue ?? true {
+      handler.report(sample)
+      lastReport = sample.time
+    }
+
+    let idle = lastSample.map {
+      $0.rxPackets == sample.rxPackets && $0.txPackets == sample.txPackets
+    }
+    lastSample = sample
+    reschedule(idle == true ? Self.idleSeconds : Self.activeSeconds)
+  }
+
+  private func reschedule(_ seconds: Int) {
+    guard seconds != interval else { return }
+    interval = seconds
+    timer.schedule(
+      deadline: .now() + .seconds(seconds), repeating: .seconds(seconds),
+      leeway: .milliseconds(100))
+  }
+}
@@ -0,0 +1,165 @@
+//
+//  ConnectionOptions.swift
+//  SwiftConnectCli
+//
+//  Options shared by the commands that talk to a VPN server
+//
+
+import ArgumentParser
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Server, protocol and authentication options common to `connect` and `authenticate`.
+struct ConnectionOptions: ParsableArguments {
+
+  @Argument(help: "VPN server URL (e.g., https://vpn.example.com)")
+  var server: String?
+
+  @Argument(help: "Username for authentication (optional, will prompt if not provided)")
+  var username: String?
+
+  @Option(name: .long, help: "VPN protocol (anyconnect, gp, pulse, nc, array)")
+  var vpnProtocol: String = "anyconnect"
+
+  @Option(name: .long, help: "JSON rules file for answering authentication forms automatically")
+  var authRules: String?
+
+  @Option(name: .long, help: "Client certificate file or PKCS#11 URI (pkcs11:...)")
+  var cert: String?
+
+  @Option(name: .long, help: "Private key file or PKCS#11 URI (defaults to --cert)")
+  var key: String?
+
+  @Flag(name: .shortAndLong, help: "Increase verbosity (-v: info, -vv: debug, -vvv: trace)")
+  var verbose: Int
+
+  // MARK: - Validation
+
+  /// Validates and returns the server URL, printing usage help if it is missing or invalid.
+  func serverURL() throws -> URL {
+    guard let server else {
+      print("\n❌ Error: Server URL is required")
+      print("\nUsage: swiftconnect-cli <server-url> [username]\n")
+      print("Example: swiftconnect-cli https://vpn.example.com myuser")
+      throw ExitCode.validationFailure
+    }
+
+    guard let serverURL = URL(string: server) else {
+      print("\n❌ Error: Invalid server URL: '\(server)'")
+      print("\nThe server URL must be a valid URL, including the protocol.")
+      print("Example: https://vpn.example.com")
+      throw ExitCode.validationFailure
+    }
+
+    return serverURL
+  }
+
+  /// Parses the VPN protocol, listing the supported ones if it is unknown.
+  func parsedProtocol() throws -> VpnProtocol {
+    guard let parsed = VpnProtocol(rawValue: vpnProtocol) else {
+      print("\n❌ Error: Invalid VPN protocol '\(vpnProtocol)'")
+      print("\nSupported protocols:")
+      print("  • anyconnect - Cisco AnyConnect")
+      print("  • gp         - GlobalProtect (Palo Alto)")
+      print("  • pulse      - Pulse Secure")
+      print("  • nc         - Juniper Network Connect")
+      print("  • array      - Array Networks")
+      throw ExitCode.validationFailure
+    }
+    return parsed
+  }
+
+  /// Converts the CLI verbosity count to a LogLevel.
+  var logLevel: LogLevel {
+    switch verbose {
+    case 0: return .error  // No -v flag: errors only
+    case 1: return .info  // -v: info level
+    case 2: return .debug  // -vv: debug level
+    default: return .trace  // -vvv or more: trace level
+    }
+  }
+
+  /// Loads auth form rules up front so pattern errors surface before connecting.
+  func loadAutoAnswer() throws -> AuthAutoAnswer? {
+    guard let authRules else { return nil }
+    do {
+      return AuthAutoAnswer(rules: try AuthRules.load(contentsOf: authRules))
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.validationFailure
+    }
+  }
+
+  /// Sets the client certificate and key on `config`, if one was given.
+  ///
+  /// PKCS#11 URIs are passed through to libopenconnect, which keeps the module
+  /// session and key handles open for the lifetime of the session.
+  func applyClientCertificate(to config: inout VpnConfiguration) throws {
+    if key != nil && cert == nil {
+      print("\n❌ Error: --key requires --cert")
+      throw ExitCode.validationFailure
+    }
+    guard let cert else { return }
+
+    for path in [cert, key].compactMap({ $0 }) where !Self.isPkcs11URI(path) {
+      guard FileManager.default.isReadableFile(atPath: path) else {
+        print("\n❌ Error: Cannot read certificate or key file '\(path)'")
+        throw ExitCode.validationFailure
+      }
+    }
+
+    config.clientCertificate = cert
+    config.clientKey = key ?? (Self.isPkcs11URI(cert) ? cert : nil)
+  }
+
+  private static func isPkcs11URI(_ value: String) -> Bool {
+    value.lowercased().hasPrefix("pkcs11:")
+  }
+
+  // Drops pin-value and pin-source so PINs never reach the terminal. RFC 7512
+  // puts them in the query (`pkcs11:token=x;object=y?pin-value=1234`), whose
+  // attributes are '&'-separated; the ';'-separated path is filtered as well.
+  private static func redacted(_ value: String) -> String {
+    guard isPkcs11URI(value) else { return value }
+    let secret = ["pin-value=", "pin-source="]
+    func keep(_ attribute: Substring) -> Bool {
+      !secret.contains { attribute.lowercased().hasPrefix($0) }
+    }
+
+    let parts = value.split(separator: "?", maxSplits: 1, omittingEmptySubsequences: false)
+    var text = parts[0].split(separator: ";", omittingEmptySubsequences: false)
+      .filter(keep)
+      .joined(separator: ";")
+    if parts.count > 1 {
+      let query = parts[1].split(separator: "&", omittingEmptySubsequences: false)
+        .filter(keep)
+        .joined(separator: "&")
+      if !query.isEmpty {
+        text += "?" + query
+      }
+    }
+    return text
+  }
+
+  /// Prints the configuration banner shown before any network activity.
+  func printBanner(serverURL: URL, vpnProtocol: VpnProtocol) {
+    print("\n" + String(repeating: "=", count: 60))
+    print("SwiftConnect CLI - OpenConnect VPN Client")
+    print(String(repeating: "=", count: 60))
+    print("\nConfiguration:")
+    print("  Server:   \(serverURL)")
+    print("  Protocol: \(vpnProtocol.rawValue)")
+    print("  Log Level: \(logLevel)")
+    if let authRules {
+      print("  Auth Rules: \(authRules)")
+    }
+    if let cert {
+      print("  Certificate: \(Self.redacted(cert))")
+    }
+  }
+}
@@ -0,0 +1,116 @@
+//
+//  DiagnosticsOptions.swift
+//  SwiftConnectCli
+//
+//  Options for the always-on diagnostics of a running session
+//
+
+import ArgumentParser
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Options controlling what a running session records for later diagnosis.
+struct DiagnosticsOptions: ParsableArguments {
+
+  @Option(name: .long, help: "Flight recorder memory budget in MiB (0 disables)")
+  var flightRecorderSize: Int = 4
+
+  @Option(name: .long, help: "Seconds of history written by a flight recorder dump")
+  var flightRecorderWindow: Int = 120
+
+  @Flag(
+    name: .long,
+    help: "Record per-packet trace logs too; debug and above are always recorded (costs CPU per packet)"
+  )
+  var flightRecorderTrace = false
+
+  @Option(name: .long, help: "Directory flight recorder dumps and SIGUSR2 profiles are written to")
+  var flightRecorderDirectory: String = "/var/tmp"
+
+  @Option(name: .long, help: "Write logs unformatted to this binary file (see log-decode)")
+  var binaryLog: String?
+
+  @Option(
+    name: .long,
+    help: "Keep traffic and RTT history in this ring file (see history; it reads \(HistoryStore.defaultPath) by default)"
+  )
+  var historyFile: String?
+
+  @Option(name: .long, help: "History file size in MiB; older samples are overwritten")
+  var historySize: Int = 4
+
+  @Option(
+    name: .long,
+    help: "Measure the gateway round-trip time with a TCP handshake every N seconds (at least 10; off by default)"
+  )
+  var gatewayRtt: Int?
+
+  @Flag(name: .long, help: "Print how long each start-up phase took, from exec to connected")
+  var startupTrace = false
+
+  /// Interval between gateway RTT samples, nil when sampling is off.
+  var gatewayRttInterval: Duration? {
+    gatewayRtt.map { max(.seconds($0), GatewayProbe.minimumInterval) }
+  }
+
+  /// Opens the history file, if one was requested.
+  func openHistory() throws -> HistoryStore? {
+    guard let historyFile else { return nil }
+    do {
+      return try HistoryStore(path: historyFile, size: historySize * 1024 * 1024)
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.failure
+    }
+  }
+
+  /// Opens the binary log, if one was requested.
+  func openBinaryLog() throws -> BinaryLog? {
+    guard let binaryLog else { return nil }
+    do {
+      return try BinaryLog(path: binaryLog)
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.failure
+    }
+  }
+
+  /// Level libopenconnect logs at. With the flight recorder on it is at least
+  /// debug, so a dump holds the lead-up to a failure whatever is printed;
+  /// per-packet trace lines only with --flight-recorder-trace. The handler
+  /// filters what is printed by the print level separately.
+  func sessionLogLevel(printing level: LogLevel) -> LogLevel {
+    guard FlightRecorder.isEnabled else { return level }
+    if flightRecorderTrace {
+      return .trace
+    }
+    return level.rank >= LogLevel.debug.rank ? level : .debug
+  }
+
+  /// Starts the flight recorder if it is enabled; failures only warn.
+  func startFlightRecorder() {
+    guard flightRecorderSize > 0 else { return }
+    do {
+      try FlightRecorder.start(
+        capacity: flightRecorderSize * 1024 * 1024,
+        window: .seconds(flightRecorderWindow),
+        directory: flightRecorderDirectory
+      )
+    } catch {
+      print("⚠️  Warning: \(error)")
+    }
+  }
+}
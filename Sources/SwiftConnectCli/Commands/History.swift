@@ -0,0 +1,92 @@
+//
+//  History.swift
+//  SwiftConnectCli
+//
+//  Queries the traffic and RTT history recorded with --history-file
+//
+
+import ArgumentParser
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+extension Cli {
+
+  struct History: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Show recorded traffic and RTT history",
+      discussion: """
+        Reads the ring file a session writes with --history-file and aggregates it
+        into one line per step. Rates only count time a session was recording.
+
+        Example:
+          swiftconnect-cli history --since 6h --step 1m
+        """
+    )
+
+    @Option(name: .long, help: "History file written by 'connect --history-file'")
+    var file: String = HistoryStore.defaultPath
+
+    @Option(name: .long, help: "How far back to show, e.g. 90m, 6h, 2d")
+    var since: String = "1h"
+
+    @Option(name: .long, help: "Aggregation step, e.g. 30s, 1m, 1h")
+    var step: String = "1m"
+
+    mutating func run() throws {
+      guard let since = Units.parseDuration(since), let step = Units.parseDuration(step),
+        Units.seconds(step) > 0
+      else {
+        print("❌ Error: Durations look like 30s, 15m, 6h or 2d")
+        throw ExitCode.validationFailure
+      }
+      guard Units.seconds(since) / Units.seconds(step) <= 100_000 else {
+        print("❌ Error: --since covers too many steps; use a larger --step")
+        throw ExitCode.validationFailure
+      }
+
+      guard let data = FileManager.default.contents(atPath: file) else {
+        print("❌ Error: Cannot read '\(file)'")
+        throw ExitCode.failure
+      }
+      let reader: HistoryReader
+      do {
+        reader = try HistoryReader(data: data)
+      } catch {
+        print("❌ Error: '\(file)': \(error)")
+        throw ExitCode.failure
+      }
+
+      // Align buckets to whole steps so repeated queries line up
+      let stepSeconds = Units.seconds(step)
+      let now = Date()
+      let end = (now.timeIntervalSince1970 / stepSeconds).rounded(.up) * stepSeconds
+      let start = end - (Units.seconds(since) / stepSeconds).rounded(.up) * stepSeconds
+      let buckets = reader.buckets(
+        since: Date(timeIntervalSince1970: start), until: Date(timeIntervalSince1970: end),
+        step: stepSeconds)
+
+      print(
+        [column("TIME", 20), column("RX", 14), column("TX", 14), column("RTT avg", 12), "RTT max"]
+          .joined())
+      for bucket in buckets {
+        let rttAverage = bucket.rtts.isEmpty ? nil : bucket.rtts.reduce(.zero, +) / bucket.rtts.count
+        print(
+          [
+            column(Timestamp.dateTime(bucket.start, seconds: stepSeconds < 60), 20),
+            column(bucket.rxRate.map { Units.bitRate(bytesPerSecond: $0) } ?? "-", 14),
+            column(bucket.txRate.map { Units.bitRate(bytesPerSecond: $0) } ?? "-", 14),
+            column(rttAverage.map(Units.milliseconds) ?? "-", 12),
+            bucket.rtts.max().map(Units.milliseconds) ?? "-",
+          ].joined())
+      }
+    }
+
+    private func column(_ text: String, _ width: Int) -> String {
+      Units.column(text, width: max(width, text.count + 1))
+    }
+  }
+}
@@ -0,0 +1,59 @@
+//
+//  LogDecode.swift
+//  SwiftConnectCli
+//
+//  Renders binary log files written by the CLI
+//
+
+import ArgumentParser
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct LogDecode: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      commandName: "log-decode",
+      abstract: "Print a binary log or flight recorder dump as text"
+    )
+
+    @Argument(help: "Binary log (--binary-log) or flight recorder dump (.scfr)")
+    var file: String
+
+    mutating func run() throws {
+      guard let data = FileManager.default.contents(atPath: file) else {
+        print("\n❌ Error: Cannot read '\(file)'")
+        throw ExitCode.failure
+      }
+
+      let records: [LogRecord]
+      do {
+        if BinaryLogReader.matches(data) {
+          records = try BinaryLogReader(data: data).records
+        } else {
+          records = try FlightRecording(data: data).records
+        }
+      } catch {
+        print("\n❌ Error: '\(file)': \(error)")
+        throw ExitCode.failure
+      }
+
+      for record in records {
+        let prefix = record.isEvent ? "EVENT" : record.level.label
+        print("[\(Timestamp.time(record.time, milliseconds: true))] \(prefix): \(record.message)")
+      }
+    }
+  }
+}
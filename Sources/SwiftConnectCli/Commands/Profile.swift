@@ -0,0 +1,81 @@
+//
+//  Profile.swift
+//  SwiftConnectCli
+//
+//  Profiles a running session's CPU use
+//
+
+import ArgumentParser
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct Profile: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Sample a running session's stacks and write folded stacks",
+      discussion: """
+        The session samples its own threads at the given frequency of CPU time,
+        unwinding through frame pointers, so neither perf nor a debugger is needed
+        on the host. The output is in folded-stack format for flamegraph.pl,
+        speedscope or inferno, with frames left as module+offset; resolve them on
+        a machine with the same binaries and their debug info using
+        scripts/symbolize-folded.sh. Sending SIGUSR2 to the session takes a
+        ten-second profile into its flight recorder directory instead.
+
+        Examples:
+          swiftconnect-cli profile --duration 30 -o vpn.folded
+          scripts/symbolize-folded.sh vpn.folded | flamegraph.pl > vpn.svg
+        """
+    )
+
+    @Option(name: .long, help: "Seconds to sample for")
+    var duration: Double = 10
+
+    @Option(name: .long, help: "Samples per second of CPU time")
+    var frequency: Int = Profiler.defaultFrequency
+
+    @Option(name: [.customShort("o"), .long], help: "Folded-stack file to write")
+    var output: String
+
+    @Option(name: .long, help: "Process id of the session (needed when several are running)")
+    var pid: Int32?
+
+    mutating func validate() throws {
+      guard duration > 0, duration <= Units.seconds(Profiler.maximumDuration) else {
+        throw ValidationError(
+          "--duration must be between 0 and \(Int(Units.seconds(Profiler.maximumDuration))) seconds")
+      }
+      guard (1...1000).contains(frequency) else {
+        throw ValidationError("--frequency must be between 1 and 1000")
+      }
+    }
+
+    mutating func run() throws {
+      // The session resolves paths against its own working directory
+      let path = URL(fileURLWithPath: output).path
+      print("🔥 Profiling for \(duration) s...")
+
+      do {
+        let summary = try ControlClient.send(
+          "profile", [String(duration), String(frequency), path], pid: pid)
+        print("🔥 \(summary)")
+      } catch {
+        print("❌ Error: \(error)")
+        throw ExitCode.failure
+      }
+    }
+  }
+}
@@ -0,0 +1,100 @@
+//
+//  Status.swift
+//  SwiftConnectCli
+//
+//  Prints the live state of running sessions
+//
+
+import ArgumentParser
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+extension Cli {
+
+  struct Status: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Show the state of running sessions",
+      discussion: """
+        Reads the shared-memory segment each session publishes, so it never
+        interrupts the session and can be polled as often as needed.
+        """
+    )
+
+    @Option(name: .long, help: "Process id of the session (default: all running sessions)")
+    var pid: Int32?
+
+    mutating func run() throws {
+      let pids = pid.map { [$0] } ?? StatsSegment.sessions()
+      guard !pids.isEmpty else {
+        print("No running sessions")
+        return
+      }
+
+      var failed = false
+      for pid in pids {
+        do {
+          print(Self.render(try StatsSegment.read(pid: pid)))
+        } catch {
+          print("❌ Error: \(error)")
+          failed = true
+        }
+      }
+      if failed {
+        throw ExitCode.failure
+      }
+    }
+
+    static func render(_ snapshot: StatsSegment.Snapshot) -> String {
+      let now = Date()
+      let uptime = Duration.seconds(now.timeIntervalSince(snapshot.started))
+      let age = Duration.seconds(now.timeIntervalSince(snapshot.updated))
+
+      var lines = [
+        "🌐 \(snapshot.server) (pid \(snapshot.pid)): "
+          + ConnectionStatus.name(forCode: snapshot.status)
+      ]
+      var route = "  Gateway:  \(snapshot.gateway.isEmpty ? "unresolved" : snapshot.gateway)"
+      if !snapshot.interface.isEmpty {
+        route += " via \(snapshot.interface)"
+      }
+      lines.append(route)
+      lines.append(
+        "  Uptime:   \(Units.elapsed(uptime)), \(snapshot.reconnects) reconnect(s), updated \(Units.elapsed(age)) ago"
+      )
+      lines.append(
+        "  ↑ TX: \(Units.bytes(snapshot.txBytes)) (\(snapshot.txPackets) packets), "
+          + Units.bitRate(bytesPerSecond: snapshot.txRate))
+      lines.append(
+        "  ↓ RX: \(Units.bytes(snapshot.rxBytes)) (\(snapshot.rxPackets) packets), "
+          + Units.bitRate(bytesPerSecond: snapshot.rxRate))
+
+      if let last = snapshot.rtts.last, let median = snapshot.rttPercentile(0.5),
+        let p95 = snapshot.rttPercentile(0.95)
+      {
+        lines.append(
+          "  RTT:      \(Units.milliseconds(last)) (median \(Units.milliseconds(median)), "
+            + "p95 \(Units.milliseconds(p95)) over \(snapshot.rtts.count) samples)")
+      }
+      if snapshot.threads > 0 {
+        lines.append("  Process:  \(processSummary(snapshot))")
+      }
+      return lines.joined(separator: "\n")
+    }
+
+    /// One-line summary of the session's own resource use.
+    static func processSummary(_ snapshot: StatsSegment.Snapshot) -> String {
+      let uptime = max(Date().timeIntervalSince(snapshot.started), 1)
+      let average = Units.seconds(snapshot.cpu) / uptime * 100
+      return "CPU \(Units.decimal(Units.seconds(snapshot.cpu), places: 1)) s (\(Units.decimal(average, places: 2))% avg), "
+        + "\(snapshot.threads) threads, RSS \(Units.bytes(snapshot.residentBytes)), "
+        + "heap \(Units.bytes(snapshot.heapBytes)), "
+        + "\(snapshot.voluntarySwitches)/\(snapshot.involuntarySwitches) ctx switches, "
+        + "\(snapshot.minorFaults)/\(snapshot.majorFaults) faults"
+    }
+  }
+}
@@ -0,0 +1,207 @@
+//
+//  Top.swift
+//  SwiftConnectCli
+//
+//  Live full-screen dashboard of a running session
+//
+
+import ArgumentParser
+import Dispatch
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+extension Cli {
+
+  struct Top: ParsableCommand {
+    static let configuration = CommandConfiguration(
+      abstract: "Show a live dashboard of a running session",
+      discussion: """
+        Reads the session's shared-memory stats segment, so watching costs the
+        session nothing. The screen is redrawn in place and only changed cells are
+        written. Press Ctrl+C to quit.
+        """
+    )
+
+    @Option(name: .long, help: "Process id of the session (needed when several are running)")
+    var pid: Int32?
+
+    @Option(name: .long, help: "Screen updates per second (at most 10)")
+    var rate: Double = 4
+
+    mutating func validate() throws {
+      guard rate > 0, rate <= 10 else {
+        throw ValidationError("--rate must be between 0 and 10")
+      }
+    }
+
+    mutating func run() throws {
+      let pid = try resolvePid()
+      // Fail before taking over the screen
+      do {
+        _ = try StatsSegment.read(pid: pid)
+      } catch {
+        print("❌ Error: \(error)")
+        throw ExitCode.failure
+      }
+
+      let dashboard = Dashboard(pid: pid)
+      dashboard.screen.enter()
+
+      signal(SIGINT, SIG_IGN)
+      signal(SIGTERM, SIG_IGN)
+      let signalSources = [SIGINT, SIGTERM].map { signalNumber in
+        let source = DispatchSource.makeSignalSource(signal: signalNumber, queue: .main)
+        source.setEventHandler {
+          dashboard.screen.leave()
+          Posix.exit(0)
+        }
+        source.resume()
+        return source
+      }
+
+      let timer = DispatchSource.makeTimerSource(queue: .main)
+      timer.schedule(deadline: .now(), repeating: 1 / rate)
+      timer.setEventHandler {
+        dashboard.refresh()
+      }
+      timer.resume()
+
+      // Sources are cancelled when released
+      withExtendedLifetime((signalSources, timer)) {
+        dispatchMain()
+      }
+    }
+
+    private func resolvePid() throws -> Int32 {
+      if let pid { return pid }
+      let sessions = StatsSegment.sessions()
+      guard sessions.count == 1 else {
+        print(
+          sessions.isEmpty
+            ? "No running sessions"
+            : "❌ Error: Several sessions are running (\(sessions.map(String.init).joined(separator: ", "))); select one with --pid"
+        )
+        throw ExitCode.failure
+      }
+      return sessions[0]
+    }
+  }
+
+  // MARK: - Dashboard
+
+  private final class Dashboard {
+    let pid: Int32
+    let screen = TerminalScreen()
+
+    // One point per segment update, newest last
+    private var txHistory: [Double] = []
+    private var rxHistory: [Double] = []
+    private var rttHistory: [Double] = []
+    private var lastUpdate: Date?
+
+    init(pid: Int32) {
+      self.pid = pid
+    }
+
+    func refresh() {
+      screen.beginFrame()
+      let width = screen.columns
+
+      guard let snapshot = try? StatsSegment.read(pid: pid) else {
+        screen.put("swiftconnect-cli top: session \(pid) has ended", row: 0)
+        screen.present()
+        return
+      }
+      record(snapshot, keep: max(width - 12, 1))
+
+      let clock = Timestamp.time()
+      screen.put("swiftconnect-cli top - \(snapshot.server) (pid \(pid))", row: 0)
+      screen.put(clock, row: 0, column: width - clock.count)
+
+      let uptime = Duration.seconds(Date().timeIntervalSince(snapshot.started))
+      var route = snapshot.gateway.isEmpty ? "unresolved" : snapshot.gateway
+      if !snapshot.interface.isEmpty {
+        route += " via \(snapshot.interface)"
+      }
+      screen.put(
+        "Status: \(ConnectionStatus.name(forCode: snapshot.status))   Gateway: \(route)   "
+          + "Up \(Units.elapsed(uptime))   Reconnects: \(snapshot.reconnects)",
+        row: 1)
+
+      screen.put(
+        "TX  \(pad(Units.bitRate(bytesPerSecond: snapshot.txRate)))  total \(Units.bytes(snapshot.txBytes)) "
+          + "(\(snapshot.txPackets) packets)",
+        row: 3, column: 2)
+      screen.put(
+        "RX  \(pad(Units.bitRate(bytesPerSecond: snapshot.rxRate)))  total \(Units.bytes(snapshot.rxBytes)) "
+          + "(\(snapshot.rxPackets) packets)",
+        row: 4, column: 2)
+
+      if let last = snapshot.rtts.last {
+        let percentiles = [("p50", 0.5), ("p90", 0.9), ("p99", 0.99), ("max", 1.0)]
+          .compactMap { name, fraction in
+            snapshot.rttPercentile(fraction).map { "\(name) \(Units.milliseconds($0))" }
+          }
+          .joined(separator: "  ")
+        screen.put("RTT \(pad(Units.milliseconds(last)))  \(percentiles)", row: 5, column: 2)
+      } else {
+        screen.put("RTT no samples yet", row: 5, column: 2)
+      }
+
+      if snapshot.threads > 0 {
+        screen.put("Process  \(Status.processSummary(snapshot))", row: 6, column: 2)
+      }
+
+      screen.put("History, one column per second (\(txHistory.count)s shown)", row: 8)
+      sparkline("TX", txHistory, row: 9)
+      sparkline("RX", rxHistory, row: 10)
+      sparkline("RTT", rttHistory, row: 11)
+
+      screen.put("Ctrl+C to quit", row: screen.rows - 1)
+      screen.present()
+    }
+
+    // Appends a point whenever the session published new counters
+    private func record(_ snapshot: StatsSegment.Snapshot, keep: Int) {
+      if snapshot.updated != lastUpdate {
+        lastUpdate = snapshot.updated
+        txHistory.append(snapshot.txRate)
+        rxHistory.append(snapshot.rxRate)
+        // RTT is sampled less often than counters; hold the last value
+        if let rtt = snapshot.rtts.last {
+          rttHistory.append(Units.seconds(rtt))
+        }
+      }
+      txHistory = Array(txHistory.suffix(keep))
+      rxHistory = Array(rxHistory.suffix(keep))
+      rttHistory = Array(rttHistory.suffix(keep))
+    }
+
+    private func sparkline(_ label: String, _ values: [Double], row: Int) {
+      let blocks: [Character] = ["▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"]
+      let peak = values.max() ?? 0
+      let line = values.map { value -> Character in
+        guard peak > 0 else { return blocks[0] }
+        return blocks[min(Int(value / peak * Double(blocks.count - 1)), blocks.count - 1)]
+      }
+      screen.put(Units.column(label, width: 4) + String(line), row: row, column: 2)
+    }
+
+    private func pad(_ text: String) -> String {
+      Units.column(text, width: 14)
+    }
+  }
+}
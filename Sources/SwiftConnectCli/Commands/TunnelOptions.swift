@@ -0,0 +1,206 @@
+//
+//  TunnelOptions.swift
+//  SwiftConnectCli
+//
+//  Options selecting how the tunnel is terminated on this host
+//
+
+import ArgumentParser
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Options for terminating the tunnel somewhere other than a system-wide TUN device.
+struct TunnelOptions: ParsableArguments {
+
+  @Option(
+    name: .long,
+    help: "Expose the VPN as a SOCKS5 proxy on [address:]port instead of a TUN device"
+  )
+  var proxyListen: String?
+
+  @Option(
+    name: .long,
+    help: "Expose the VPN as an HTTP CONNECT proxy on [address:]port instead of a TUN device"
+  )
+  var httpProxyListen: String?
+
+  @Option(
+    name: .long,
+    help: ArgumentHelp(
+      "Forward a local port over the VPN (repeatable)",
+      valueName: "[address:]port:host:hostport"
+    )
+  )
+  var forward: [String] = []
+
+  @Option(name: .long, help: "Userspace TCP/IP stack helper (tunsocks-compatible)")
+  var userspaceHelper: String = "tunsocks"
+
+  @Option(name: .long, help: "Create the TUN device, routes and DNS inside this network namespace")
+  var netns: String?
+
+  @Option(name: .long, help: "Install VPN routes into this routing table instead of the main one")
+  var routeTable: UInt32?
+
+  @Option(name: .long, help: "Route packets with this fwmark through the VPN (with --route-table)")
+  var routeFwmark: String?
+
+  @Option(name: .long, help: "Route sockets of this uid or uid range through the VPN (with --route-table)")
+  var routeUid: String?
+
+  @Option(
+    name: .long,
+    help: "Route sockets of this cgroup v2 path through the VPN (with --route-table, needs nftables)"
+  )
+  var routeCgroup: String?
+
+  @Option(name: .long, help: "vpnc-script used to configure the TUN device, routes and DNS")
+  var vpncScript: String?
+
+  @Option(
+    name: .long,
+    help: "MiB of huge-page backed, prefaulted memory for --forward relay buffers (0: allocate per connection)"
+  )
+  var packetMemory: Int = 0
+
+  @Flag(name: .long, help: "Lock --packet-memory into RAM (needs RLIMIT_MEMLOCK or root)")
+  var packetMemoryLock = false
+
+  // MARK: - Validation
+
+  /// The userspace stack to use, or nil for the kernel TUN path.
+  func userspaceStack() throws -> UserspaceStack? {
+    guard proxyListen != nil || httpProxyListen != nil || !forward.isEmpty else { return nil }
+
+    var stack = UserspaceStack(helper: userspaceHelper)
+    if let proxyListen {
+      stack.socksListen = try Self.listenAddress(proxyListen, option: "--proxy-listen")
+    }
+    if let httpProxyListen {
+      stack.httpListen = try Self.listenAddress(httpProxyListen, option: "--http-proxy-listen")
+    }
+
+    // Forwards reach the VPN through a private SOCKS endpoint unless one was asked for
+    if stack.socksListen == nil && !forward.isEmpty {
+      do {
+        stack.socksListen = UserspaceStack.ListenAddress(
+          host: "127.0.0.1", port: try Sockets.freeLoopbackPort())
+      } catch {
+        print("\n❌ Error: Cannot reserve a local port for forwarding: \(error)")
+        throw ExitCode.failure
+      }
+    }
+    return stack
+  }
+
+  /// One forwarder per --forward, relaying through the stack's SOCKS endpoint.
+  func portForwarders(through stack: UserspaceStack) throws -> [PortForwarder] {
+    guard let socks = stack.socksListen else { return [] }
+    let memory = try openPacketMemory()
+
+    return try forward.map { value in
+      guard let spec = PortForwarder.Spec(value) else {
+        print("\n❌ Error: Invalid --forward '\(value)'")
+        print("\nExpected [address:]port:host:hostport, e.g. 5432:db.internal:5432")
+        throw ExitCode.validationFailure
+      }
+      return PortForwarder(spec: spec, socks: socks, memory: memory)
+    }
+  }
+
+  /// Maps the relay buffer region, if --packet-memory was given.
+  func openPacketMemory() throws -> PacketMemory? {
+    guard packetMemory > 0, !forward.isEmpty else { return nil }
+    do {
+      let memory = try PacketMemory(
+        budget: packetMemory * 1024 * 1024, bufferSize: PortForwarder.bufferSize,
+        lock: packetMemoryLock)
+      print("🧱 Packet memory: \(memory.summary)")
+      return memory
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.failure
+    }
+  }
+
+  private static func listenAddress(_ value: String, option: String) throws
+    -> UserspaceStack.ListenAddress
+  {
+    guard let address = UserspaceStack.ListenAddress(value) else {
+      print("\n❌ Error: Invalid \(option) '\(value)'")
+      print("\nExpected [address:]port, e.g. 1080 or 127.0.0.1:1080")
+      throw ExitCode.validationFailure
+    }
+    return address
+  }
+
+  /// The vpnc-script libopenconnect should run, or nil for its default.
+  ///
+  /// Options that change where the tunnel is configured install a generated
+  /// wrapper around the real script.
+  func vpncScriptPath(usingUserspaceStack: Bool) throws -> String? {
+    let policyRouting = try self.policyRouting()
+    guard netns != nil || policyRouting != nil else { return vpncScript }
+
+    guard !usingUserspaceStack else {
+      print(
+        "\n❌ Error: --netns and --route-table need a TUN device and cannot be combined with proxy or forward options"
+      )
+      throw ExitCode.validationFailure
+    }
+
+    do {
+      var wrapper = VpncScriptWrapper(vpncScript: try VpncScriptWrapper.locateVpncScript(vpncScript))
+      if let netns {
+        try VpncScriptWrapper.prepareNamespace(netns)
+        wrapper.namespace = netns
+      }
+      wrapper.policyRouting = policyRouting
+      return try wrapper.install()
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.failure
+    }
+  }
+
+  /// Policy routing settings, or nil when routes go into the main table.
+  func policyRouting() throws -> PolicyRouting? {
+    guard let routeTable else {
+      guard routeFwmark == nil, routeUid == nil, routeCgroup == nil else {
+        print("\n❌ Error: --route-fwmark, --route-uid and --route-cgroup require --route-table")
+        throw ExitCode.validationFailure
+      }
+      return nil
+    }
+
+    var policy = PolicyRouting(table: routeTable)
+    if let routeFwmark {
+      // Accept decimal or 0x-prefixed hexadecimal, like ip-rule(8)
+      let mark =
+        routeFwmark.lowercased().hasPrefix("0x")
+        ? UInt32(routeFwmark.dropFirst(2), radix: 16) : UInt32(routeFwmark)
+      guard let mark, mark != 0 else {
+        print("\n❌ Error: Invalid --route-fwmark '\(routeFwmark)'")
+        throw ExitCode.validationFailure
+      }
+      policy.fwmark = mark
+    }
+    if let routeUid {
+      policy.uidRange = routeUid.contains("-") ? routeUid : "\(routeUid)-\(routeUid)"
+    }
+    policy.cgroup = routeCgroup
+
+    do {
+      try policy.validate()
+    } catch {
+      print("\n❌ Error: \(error)")
+      throw ExitCode.validationFailure
+    }
+    return policy
+  }
+}
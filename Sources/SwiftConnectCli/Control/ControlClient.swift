@@ -0,0 +1,96 @@
+//
+//  ControlClient.swift
+//  SwiftConnectCli
+//
+//  Sends commands to a running session's control socket
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Client side of ``ControlServer``.
+enum ControlClient {
+
+  /// Error thrown when no session can be reached or a command fails.
+  struct ClientError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Sends `command` with `arguments` to the session `pid`, or to the only
+  /// running session when `pid` is nil, and returns the command's output.
+  static func send(_ command: String, _ arguments: [String] = [], pid: Int32? = nil) throws -> String
+  {
+    do {
+      // A missing directory only means no session is running
+      try ControlServer.checkDirectory(allowMissing: true)
+    } catch {
+      throw ClientError(description: "Refusing to use the control socket: \(error)")
+    }
+    let path = try socketPath(pid: pid)
+    let request = ([command] + arguments).joined(separator: "\t") + "\n"
+
+    let fd: Int32
+    do {
+      fd = try Sockets.openUnixConnection(path: path)
+    } catch {
+      throw ClientError(description: "Cannot reach session: \(error)")
+    }
+    defer { close(fd) }
+
+    let bytes = Array(request.utf8)
+    guard Sockets.writeAll(fd, bytes, bytes.count) else {
+      throw ClientError(description: "Cannot send command: \(String(cString: strerror(errno)))")
+    }
+
+    let reply = String(decoding: Sockets.readToEnd(fd), as: UTF8.self)
+    let status = reply.prefix { $0 != "\n" }
+    let output = String(reply.dropFirst(status.count + 1))
+    switch status {
+    case "ok": return output
+    case "error": throw ClientError(description: output)
+    default: throw ClientError(description: "Malformed reply from session")
+    }
+  }
+
+  /// Process ids of sessions with a control socket.
+  static func runningSessions() -> [Int32] {
+    let entries = (try? FileManager.default.contentsOfDirectory(atPath: ControlServer.directory)) ?? []
+    return entries.compactMap { entry in
+      guard entry.hasSuffix(".sock"), let pid = Int32(entry.dropLast(5)),
+        kill(pid, 0) == 0 || errno == EPERM
+      else { return nil }
+      return pid
+    }
+    .sorted()
+  }
+
+  private static func socketPath(pid: Int32?) throws -> String {
+    if let pid {
+      return ControlServer.path(for: pid)
+    }
+
+    let sessions = runningSessions()
+    switch sessions.count {
+    case 0:
+      throw ClientError(
+        description: "No running session found in \(ControlServer.directory) (sessions run as root are only visible to root)"
+      )
+    case 1:
+      return ControlServer.path(for: sessions[0])
+    default:
+      let pids = sessions.map(String.init).joined(separator: ", ")
+      throw ClientError(description: "Several sessions are running (\(pids)); select one with --pid")
+    }
+  }
+}
@@ -0,0 +1,162 @@
+//
+//  ControlServer.swift
+//  SwiftConnectCli
+//
+//  Local command socket of a running session
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Accepts commands for a running session on a Unix domain socket.
+///
+/// Each session listens on `<directory>/<pid>.sock`. A client connects, sends
+/// one request line of tab-separated words, the first naming the command, and
+/// reads until the server closes the connection. The reply's first line is
+/// `ok` or `error`; anything after it is the command's output. Each client is
+/// served on its own thread, so a long-running command such as `profile` does
+/// not hold up the others.
+enum ControlServer {
+
+  /// Error thrown by command handlers; its description is sent to the client.
+  struct CommandError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Error thrown when the socket directory is not safe to use.
+  struct DirectoryError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Handles the arguments following the command name and returns its output.
+  typealias Handler = @Sendable (_ arguments: [String]) throws -> String
+
+  /// Longest request line accepted.
+  static let maximumRequestLength = 64 * 1024
+
+  private static let handlers = Mutex<[String: Handler]>([:])
+  private static let socketPath = Mutex<String?>(nil)
+
+  /// Directory holding session sockets: system-wide for root, per user otherwise.
+  static var directory: String {
+    if getuid() == 0 {
+      return "/var/run/swiftconnect-cli"
+    }
+    let base =
+      ProcessInfo.processInfo.environment["XDG_RUNTIME_DIR"]
+      ?? FileManager.default.temporaryDirectory.path
+    return base + "/swiftconnect-cli-\(getuid())"
+  }
+
+  /// Socket path of the session with process id `pid`.
+  static func path(for pid: Int32) -> String {
+    "\(directory)/\(pid).sock"
+  }
+
+  /// Checks that `directory` is a real directory owned by this user with
+  /// mode 0700. Without XDG_RUNTIME_DIR it lives in the shared temporary
+  /// directory, where another user could create it first and receive or
+  /// impersonate the socket. A missing directory passes with `allowMissing`.
+  static func checkDirectory(allowMissing: Bool = false) throws {
+    let directory = directory
+    var status = stat()
+    guard lstat(directory, &status) == 0 else {
+      if allowMissing && errno == ENOENT { return }
+      throw DirectoryError(
+        description: "Cannot inspect '\(directory)': \(String(cString: strerror(errno)))")
+    }
+    guard status.st_mode & S_IFMT == S_IFDIR else {
+      throw DirectoryError(description: "'\(directory)' is not a directory")
+    }
+    guard status.st_uid == getuid() else {
+      throw DirectoryError(description: "'\(directory)' is owned by uid \(status.st_uid), not \(getuid())")
+    }
+    guard status.st_mode & 0o777 == 0o700 else {
+      throw DirectoryError(
+        description: "'\(directory)' has mode \(String(status.st_mode & 0o777, radix: 8)), expected 700")
+    }
+  }
+
+  /// Makes `command` available to clients.
+  static func register(_ command: String, handler: @escaping Handler) {
+    handlers.withLock { $0[command] = handler }
+  }
+
+  /// Creates the socket and starts serving requests; the socket is removed at exit.
+  static func start() throws {
+    // Owner-only directory: commands reach into the data path
+    let directory = directory
+    if mkdir(directory, 0o700) != 0 && errno != EEXIST {
+      throw DirectoryError(
+        description: "Cannot create '\(directory)': \(String(cString: strerror(errno)))")
+    }
+    try checkDirectory()
+    let path = path(for: getpid())
+    let listener = try Sockets.openUnixListener(path: path)
+    chmod(path, 0o600)
+
+    socketPath.withLock { $0 = path }
+    atexit {
+      if let path = ControlServer.socketPath.withLock({ $0 }) {
+        unlink(path)
+      }
+    }
+
+    Threads.detach(name: "control") {
+      while true {
+        let client = accept(listener, nil, nil)
+        guard client >= 0 else {
+          if errno == EINTR || errno == ECONNABORTED { continue }
+          print("⚠️  Warning: Control socket stopped accepting: \(String(cString: strerror(errno)))")
+          return
+        }
+        Threads.detach(name: "control-c") {
+          serve(client)
+          close(client)
+        }
+      }
+    }
+  }
+
+  // MARK: - Requests
+
+  private static func serve(_ client: Int32) {
+    var request: [UInt8] = []
+    var byte: UInt8 = 0
+    while request.count < maximumRequestLength, read(client, &byte, 1) == 1, byte != 0x0A {
+      request.append(byte)
+    }
+
+    let words = String(decoding: request, as: UTF8.self)
+      .split(separator: "\t", omittingEmptySubsequences: false)
+      .map(String.init)
+
+    let reply: String
+    if let command = words.first, let handler = handlers.withLock({ $0[command] }) {
+      do {
+        reply = "ok\n" + (try handler(Array(words.dropFirst())))
+      } catch {
+        reply = "error\n\(error)"
+      }
+    } else {
+      let known = handlers.withLock { $0.keys.sorted() }.joined(separator: ", ")
+      reply = "error\nUnknown command '\(words.first ?? "")' (available: \(known))"
+    }
+
+    let bytes = Array(reply.utf8)
+    _ = Sockets.writeAll(client, bytes, bytes.count)
+  }
+}
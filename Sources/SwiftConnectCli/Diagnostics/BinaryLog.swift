@@ -0,0 +1,266 @@
+//
+//  BinaryLog.swift
+//  SwiftConnectCli
+//
+//  Memory-mapped binary log with interned message templates
+//
+
+import OpenConnectKit
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Writes log records to a memory-mapped file without formatting them.
+///
+/// libopenconnect delivers each log line already formatted, so the variable
+/// parts are recovered instead: runs starting with a digit (numbers, IP
+/// addresses, hex values) become arguments, and what remains is the message
+/// template. Each template is written once and then referred to by id, so a
+/// record costs a timestamp delta, a template id and the argument bytes.
+/// Lines that contain the placeholder byte themselves, and new templates once
+/// ``maximumTemplates`` are interned, are written as raw records instead.
+/// `swiftconnect-cli log-decode` renders the file.
+///
+/// File layout: the 24-byte header `"SCBL" | u32 version | u64 realtime_ns |
+/// u64 monotonic_ns`, followed by records that each start with a kind byte:
+///
+/// - `1` template: varint id, varint length, UTF-8 bytes, one
+///   ``placeholder`` per argument
+/// - `2` message: varint monotonic delta (ns), u8 level, varint template id,
+///   u8 argument count, then per argument a varint length and bytes
+/// - `3` raw: varint monotonic delta (ns), u8 level, varint length, UTF-8 bytes
+///
+/// A zero kind byte marks the end of the data.
+final class BinaryLog: Sendable {
+
+  static let magic = Array("SCBL".utf8)
+  static let version: UInt32 = 2
+  static let headerSize = 24
+  static let placeholder: UInt8 = 0x01
+
+  /// Templates interned per file. Lines whose argument runs are not all
+  /// digit-led (hostnames with counters, random tokens) can each make a new
+  /// template; past this many they are written raw rather than kept in memory.
+  static let maximumTemplates = 4096
+
+  enum RecordKind: UInt8 {
+    case template = 1
+    case message = 2
+    case raw = 3
+  }
+
+  /// Error thrown when the log file cannot be created or grown.
+  struct FileError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  private struct State: ~Copyable {
+    let fd: Int32
+    var mapping: UnsafeMutableRawPointer
+    var capacity: Int
+    var used: Int
+    var lastTimestamp: UInt64
+    var templates: [[UInt8]: UInt64] = [:]
+    var scratch: [UInt8] = []
+    var closed = false
+  }
+
+  /// Initial file size; doubled whenever it fills up.
+  private static let initialCapacity = 4 * 1024 * 1024
+
+  private let state: Mutex<State>
+
+  init(path: String) throws {
+    let fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0o600)
+    guard fd >= 0 else {
+      throw FileError(
+        description: "Cannot create binary log '\(path)': \(String(cString: strerror(errno)))")
+    }
+
+    guard let mapping = Self.map(fd, capacity: Self.initialCapacity) else {
+      let error = FileError(
+        description: "Cannot map binary log '\(path)': \(String(cString: strerror(errno)))")
+      Posix.close(fd)
+      throw error
+    }
+
+    // Header anchors monotonic record timestamps to wall-clock time
+    let monotonic = Self.monotonicNanoseconds()
+    var header = Self.magic
+    withUnsafeBytes(of: Self.version.littleEndian) { header += $0 }
+    withUnsafeBytes(of: UInt64(Date().timeIntervalSince1970 * 1e9).littleEndian) { header += $0 }
+    withUnsafeBytes(of: monotonic.littleEndian) { header += $0 }
+    header.withUnsafeBytes { mapping.copyMemory(from: $0.baseAddress!, byteCount: $0.count) }
+
+    state = Mutex(
+      State(
+        fd: fd,
+        mapping: mapping,
+        capacity: Self.initialCapacity,
+        used: header.count,
+        lastTimestamp: monotonic
+      )
+    )
+  }
+
+  /// Appends one log line.
+  func write(_ message: String, level: LogLevel) {
+    let bytes = Array(message.utf8)
+
+    // A literal placeholder byte would be read back as an argument
+    guard !bytes.contains(Self.placeholder) else {
+      writeRaw(bytes, level: level)
+      return
+    }
+
+    // Split into template and arguments outside the lock
+    var template: [UInt8] = []
+    template.reserveCapacity(bytes.count)
+    var arguments: [ArraySlice<UInt8>] = []
+    var index = 0
+    while index < bytes.count {
+      if Self.isDigit(bytes[index]) && arguments.count < 255 {
+        let start = index
+        while index < bytes.count && Self.isArgumentByte(bytes[index]) {
+          index += 1
+        }
+        arguments.append(bytes[start..<index])
+        template.append(Self.placeholder)
+      } else {
+        template.append(bytes[index])
+        index += 1
+      }
+    }
+
+    state.withLock { state in
+      guard !state.closed else { return }
+      state.scratch.removeAll(keepingCapacity: true)
+
+      // Taken under the lock so deltas never go backwards
+      let timestamp = Self.monotonicNanoseconds()
+
+      // Intern the template the first time it is seen
+      let id: UInt64
+      if let existing = state.templates[template] {
+        id = existing
+      } else if state.templates.count >= Self.maximumTemplates {
+        Self.appendRaw(bytes, level: level, timestamp: timestamp, to: &state)
+        return
+      } else {
+        id = UInt64(state.templates.count)
+        state.templates[template] = id
+        state.scratch.append(RecordKind.template.rawValue)
+        Varint.append(id, to: &state.scratch)
+        Varint.append(UInt64(template.count), to: &state.scratch)
+        state.scratch += template
+      }
+
+      state.scratch.append(RecordKind.message.rawValue)
+      Varint.append(timestamp &- state.lastTimestamp, to: &state.scratch)
+      state.scratch.append(level.rank)
+      Varint.append(id, to: &state.scratch)
+      state.scratch.append(UInt8(arguments.count))
+      for argument in arguments {
+        Varint.append(UInt64(argument.count), to: &state.scratch)
+        state.scratch += argument
+      }
+      state.lastTimestamp = timestamp
+
+      let record = state.scratch
+      Self.append(record, to: &state)
+    }
+  }
+
+  /// Appends one log line as a raw record.
+  private func writeRaw(_ bytes: [UInt8], level: LogLevel) {
+    state.withLock { state in
+      guard !state.closed else { return }
+      Self.appendRaw(bytes, level: level, timestamp: Self.monotonicNanoseconds(), to: &state)
+    }
+  }
+
+  /// Truncates the file to its contents and unmaps it. Later writes are ignored.
+  func close() {
+    state.withLock { state in
+      guard !state.closed else { return }
+      state.closed = true
+      munmap(state.mapping, state.capacity)
+      ftruncate(state.fd, off_t(state.used))
+      Posix.close(state.fd)
+    }
+  }
+
+  // MARK: - Private
+
+  private static func appendRaw(
+    _ bytes: [UInt8], level: LogLevel, timestamp: UInt64, to state: inout State
+  ) {
+    state.scratch.removeAll(keepingCapacity: true)
+    state.scratch.append(RecordKind.raw.rawValue)
+    Varint.append(timestamp &- state.lastTimestamp, to: &state.scratch)
+    state.scratch.append(level.rank)
+    Varint.append(UInt64(bytes.count), to: &state.scratch)
+    state.scratch += bytes
+    state.lastTimestamp = timestamp
+
+    let record = state.scratch
+    append(record, to: &state)
+  }
+
+  private static func append(_ bytes: [UInt8], to state: inout State) {
+    if state.used + bytes.count + 1 > state.capacity {
+      // Grow: unmap, extend the file, and map it again at the new size
+      var capacity = state.capacity * 2
+      while state.used + bytes.count + 1 > capacity { capacity *= 2 }
+      munmap(state.mapping, state.capacity)
+      guard let mapping = map(state.fd, capacity: capacity) else {
+        print("⚠️  Warning: Binary log stopped: \(String(cString: strerror(errno)))")
+        ftruncate(state.fd, off_t(state.used))
+        state.closed = true
+        return
+      }
+      state.mapping = mapping
+      state.capacity = capacity
+    }
+
+    bytes.withUnsafeBytes {
+      (state.mapping + state.used).copyMemory(from: $0.baseAddress!, byteCount: $0.count)
+    }
+    state.used += bytes.count
+  }
+
+  private static func map(_ fd: Int32, capacity: Int) -> UnsafeMutableRawPointer? {
+    guard ftruncate(fd, off_t(capacity)) == 0 else { return nil }
+    let mapping = mmap(nil, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+    guard let mapping, mapping != UnsafeMutableRawPointer(bitPattern: -1) else { return nil }
+    return mapping
+  }
+
+  private static func isDigit(_ byte: UInt8) -> Bool {
+    byte >= 0x30 && byte <= 0x39
+  }
+
+  // Digits, hex letters and the separators of IPv4/IPv6 addresses and decimals
+  private static func isArgumentByte(_ byte: UInt8) -> Bool {
+    isDigit(byte) || (byte >= 0x61 && byte <= 0x66) || (byte >= 0x41 && byte <= 0x46)
+      || byte == 0x2e || byte == 0x3a || byte == 0x78
+  }
+
+  static func monotonicNanoseconds() -> UInt64 {
+    var now = timespec()
+    clock_gettime(CLOCK_MONOTONIC, &now)
+    return UInt64(now.tv_sec) * 1_000_000_000 + UInt64(now.tv_nsec)
+  }
+}
@@ -0,0 +1,134 @@
+//
+//  BinaryLogReader.swift
+//  SwiftConnectCli
+//
+//  Decoder for files written by BinaryLog
+//
+
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Reads a binary log back into records, expanding templates.
+struct BinaryLogReader {
+
+  /// Error thrown when a file is not a valid binary log.
+  struct FormatError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  let records: [LogRecord]
+
+  /// Whether `data` starts with the binary log magic.
+  static func matches(_ data: Data) -> Bool {
+    data.starts(with: BinaryLog.magic)
+  }
+
+  init(data: Data) throws {
+    let bytes = [UInt8](data)
+    guard bytes.count >= BinaryLog.headerSize, Self.matches(data) else {
+      throw FormatError(description: "Not a binary log")
+    }
+    let version = UInt32(Self.load(bytes, at: 4, size: 4))
+    // Version 1 files are the same format without raw records
+    guard (1...BinaryLog.version).contains(version) else {
+      throw FormatError(description: "Unsupported binary log version \(version)")
+    }
+
+    let startRealtime = Double(Self.load(bytes, at: 8, size: 8)) / 1e9
+    var timestamp = Self.load(bytes, at: 16, size: 8)
+    let startMonotonic = timestamp
+
+    var templates: [UInt64: [UInt8]] = [:]
+    var records: [LogRecord] = []
+    var offset = BinaryLog.headerSize
+
+    func truncated() -> FormatError {
+      FormatError(description: "Truncated record at offset \(offset)")
+    }
+
+    func append(_ message: [UInt8], delta: UInt64, level: UInt8) {
+      timestamp &+= delta
+      records.append(
+        LogRecord(
+          time: Date(
+            timeIntervalSince1970: startRealtime + Double(timestamp &- startMonotonic) / 1e9),
+          isEvent: false,
+          level: LogLevel(rank: level),
+          message: String(decoding: message, as: UTF8.self)
+        )
+      )
+    }
+
+    // A zero kind byte (or the end of the file) ends the data
+    while offset < bytes.count, let kind = BinaryLog.RecordKind(rawValue: bytes[offset]) {
+      offset += 1
+      switch kind {
+      case .template:
+        guard let id = Varint.read(bytes, at: &offset),
+          let length = Varint.read(bytes, at: &offset),
+          offset + Int(length) <= bytes.count
+        else { throw truncated() }
+        templates[id] = Array(bytes[offset..<offset + Int(length)])
+        offset += Int(length)
+
+      case .message:
+        guard let delta = Varint.read(bytes, at: &offset), offset + 1 < bytes.count else {
+          throw truncated()
+        }
+        let level = bytes[offset]
+        offset += 1
+        guard let id = Varint.read(bytes, at: &offset), offset < bytes.count,
+          let template = templates[id]
+        else { throw truncated() }
+        let count = Int(bytes[offset])
+        offset += 1
+
+        var arguments: [ArraySlice<UInt8>] = []
+        for _ in 0..<count {
+          guard let length = Varint.read(bytes, at: &offset), offset + Int(length) <= bytes.count
+          else { throw truncated() }
+          arguments.append(bytes[offset..<offset + Int(length)])
+          offset += Int(length)
+        }
+
+        // Substitute the arguments back into the template in order
+        var message: [UInt8] = []
+        var next = arguments.makeIterator()
+        for byte in template {
+          if byte == BinaryLog.placeholder, let argument = next.next() {
+            message += argument
+          } else {
+            message.append(byte)
+          }
+        }
+
+        append(message, delta: delta, level: level)
+
+      case .raw:
+        guard let delta = Varint.read(bytes, at: &offset), offset + 1 < bytes.count else {
+          throw truncated()
+        }
+        let level = bytes[offset]
+        offset += 1
+        guard let length = Varint.read(bytes, at: &offset), offset + Int(length) <= bytes.count
+        else { throw truncated() }
+        append(Array(bytes[offset..<offset + Int(length)]), delta: delta, level: level)
+        offset += Int(length)
+      }
+    }
+    self.records = records
+  }
+
+  private static func load(_ bytes: [UInt8], at offset: Int, size: Int) -> UInt64 {
+    var value: UInt64 = 0
+    for index in (0..<size).reversed() {
+      value = value << 8 | UInt64(bytes[offset + index])
+    }
+    return value
+  }
+}
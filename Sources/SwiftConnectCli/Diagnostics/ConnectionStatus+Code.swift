@@ -0,0 +1,35 @@
+//
+//  ConnectionStatus+Code.swift
+//  SwiftConnectCli
+//
+//  Numeric status codes shared by probes and the stats segment
+//
+
+import CSwiftConnectSupport
+import OpenConnectKit
+
+extension ConnectionStatus {
+
+  /// One of the SCS_STATUS_* values from probes.h.
+  var code: Int32 {
+    switch self {
+    case .disconnected: return Int32(SCS_STATUS_DISCONNECTED)
+    case .connecting: return Int32(SCS_STATUS_CONNECTING)
+    case .connected: return Int32(SCS_STATUS_CONNECTED)
+    case .reconnecting: return Int32(SCS_STATUS_RECONNECTING)
+    case .disconnecting: return Int32(SCS_STATUS_DISCONNECTING)
+    }
+  }
+
+  /// Display name for a status code read back from a probe or stats segment.
+  static func name(forCode code: Int32) -> String {
+    switch Int(code) {
+    case SCS_STATUS_DISCONNECTED: return "Disconnected"
+    case SCS_STATUS_CONNECTING: return "Connecting"
+    case SCS_STATUS_CONNECTED: return "Connected"
+    case SCS_STATUS_RECONNECTING: return "Reconnecting"
+    case SCS_STATUS_DISCONNECTING: return "Disconnecting"
+    default: return "Unknown (\(code))"
+    }
+  }
+}
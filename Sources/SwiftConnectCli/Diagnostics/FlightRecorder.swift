@@ -0,0 +1,115 @@
+//
+//  FlightRecorder.swift
+//  SwiftConnectCli
+//
+//  Always-on capture of recent logs and events, dumped on failure
+//
+
+import CSwiftConnectSupport
+import OpenConnectKit
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Keeps the last few minutes of logs and session events in memory.
+///
+/// Logs are recorded down to debug level whatever is printed. Trace level is
+/// opt-in (--flight-recorder-trace): libopenconnect then formats a line per
+/// packet, and each one crosses into Swift before it reaches the ring.
+///
+/// Recording copies the message bytes into a fixed-size ring; timestamps and
+/// level prefixes are only formatted when a dump is decoded with
+/// `swiftconnect-cli log-decode`. Dumps are written when the session ends with
+/// an error, on SIGUSR1, and from crash signals.
+enum FlightRecorder {
+
+  /// Error thrown when the recorder cannot be set up.
+  struct StartError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  private struct Settings {
+    let window: Duration
+    let directory: String
+  }
+
+  private static let settings = Mutex<Settings?>(nil)
+
+  /// Whether `start` succeeded.
+  static var isEnabled: Bool {
+    settings.withLock { $0 != nil }
+  }
+
+  /// Allocates the ring and installs the crash handler.
+  static func start(capacity: Int, window: Duration, directory: String) throws {
+    guard scs_fr_init(capacity) == 0 else {
+      throw StartError(description: "Cannot allocate \(capacity) bytes for the flight recorder")
+    }
+
+    let windowNanoseconds = nanoseconds(window)
+    let crashPath = path(in: directory, reason: "crash")
+    if scs_fr_install_crash_handler(crashPath, windowNanoseconds) != 0 {
+      print("⚠️  Warning: Flight recorder will not dump on crashes")
+    }
+
+    settings.withLock { $0 = Settings(window: window, directory: directory) }
+  }
+
+  /// Records a log line exactly as libopenconnect delivered it.
+  static func record(log message: String, level: LogLevel) {
+    var message = message
+    message.withUTF8 { bytes in
+      scs_fr_record(UInt8(SCS_FR_KIND_LOG), level.rank, bytes.baseAddress, bytes.count)
+    }
+  }
+
+  /// Records a CLI-side event such as a status change.
+  static func record(event: String) {
+    var event = event
+    event.withUTF8 { bytes in
+      scs_fr_record(UInt8(SCS_FR_KIND_EVENT), LogLevel.info.rank, bytes.baseAddress, bytes.count)
+    }
+  }
+
+  /// Writes the recording window to a new file and returns its path.
+  @discardableResult
+  static func dump(reason: String) -> String? {
+    guard let settings = settings.withLock({ $0 }) else { return nil }
+
+    let path = path(in: settings.directory, reason: reason)
+    let fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0o600)
+    guard fd >= 0 else {
+      print("⚠️  Warning: Cannot write flight recording '\(path)': \(String(cString: strerror(errno)))")
+      return nil
+    }
+    defer { close(fd) }
+
+    guard scs_fr_dump(fd, nanoseconds(settings.window)) == 0 else {
+      print("⚠️  Warning: Flight recording '\(path)' is incomplete: \(String(cString: strerror(errno)))")
+      return nil
+    }
+    return path
+  }
+
+  // MARK: - Private
+
+  private static func path(in directory: String, reason: String) -> String {
+    "\(directory)/swiftconnect-cli-\(getpid())-\(reason)-\(time(nil)).scfr"
+  }
+
+  private static func nanoseconds(_ duration: Duration) -> UInt64 {
+    UInt64(max(Units.seconds(duration), 0) * 1e9)
+  }
+}
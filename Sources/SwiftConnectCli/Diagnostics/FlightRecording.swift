@@ -0,0 +1,82 @@
+//
+//  FlightRecording.swift
+//  SwiftConnectCli
+//
+//  Reader for flight recorder dumps
+//
+
+import CSwiftConnectSupport
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// A flight recorder dump loaded from disk.
+struct FlightRecording {
+
+  /// Error thrown when a file is not a valid dump.
+  struct FormatError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  let records: [LogRecord]
+
+  /// Whether `data` starts with the flight recorder magic.
+  static func matches(_ data: Data) -> Bool {
+    data.starts(with: Array(SCS_FR_MAGIC.utf8))
+  }
+
+  init(data: Data) throws {
+    let bytes = [UInt8](data)
+    let headerSize = Int(SCS_FR_HEADER_SIZE)
+    let recordHeaderSize = Int(SCS_FR_RECORD_HEADER_SIZE)
+
+    guard bytes.count >= headerSize, Self.matches(data) else {
+      throw FormatError(description: "Not a flight recording")
+    }
+    let version: UInt32 = Self.load(bytes, at: 4)
+    guard version == UInt32(SCS_FR_VERSION) else {
+      throw FormatError(description: "Unsupported flight recording version \(version)")
+    }
+
+    // Anchor monotonic record timestamps to wall-clock time at dump
+    let realtime: UInt64 = Self.load(bytes, at: 8)
+    let monotonic: UInt64 = Self.load(bytes, at: 16)
+
+    var records: [LogRecord] = []
+    var offset = headerSize
+    while offset + recordHeaderSize <= bytes.count {
+      let timestamp: UInt64 = Self.load(bytes, at: offset)
+      let kind = bytes[offset + 8]
+      let level = bytes[offset + 9]
+      let length = Int(Self.load(bytes, at: offset + 10) as UInt16)
+      let start = offset + recordHeaderSize
+      guard start + length <= bytes.count else {
+        throw FormatError(description: "Truncated record at offset \(offset)")
+      }
+
+      let age = Double(Int64(bitPattern: monotonic &- timestamp)) / 1e9
+      records.append(
+        LogRecord(
+          time: Date(timeIntervalSince1970: Double(realtime) / 1e9 - age),
+          isEvent: kind == UInt8(SCS_FR_KIND_EVENT),
+          level: LogLevel(rank: level),
+          message: String(decoding: bytes[start..<start + length], as: UTF8.self)
+        )
+      )
+      offset = start + length
+    }
+    self.records = records
+  }
+
+  private static func load<T: FixedWidthInteger>(_ bytes: [UInt8], at offset: Int) -> T {
+    var value: T = 0
+    for index in (0..<MemoryLayout<T>.size).reversed() {
+      value = value << 8 | T(bytes[offset + index])
+    }
+    return value
+  }
+}
@@ -0,0 +1,74 @@
+//
+//  GatewayProbe.swift
+//  SwiftConnectCli
+//
+//  Periodic round-trip time measurement to the VPN gateway
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Samples the round-trip time to the gateway into the stats segment.
+///
+/// ICMP echo needs a raw socket, but a TCP handshake with the gateway's HTTPS
+/// port completes after exactly one round trip and needs no privileges. The
+/// gateway is resolved once, so DNS time is never counted, and the connection
+/// is closed as soon as it is established. The gateway is always routed
+/// outside the tunnel, so this measures the path the tunnel runs over.
+///
+/// Sampling is opt-in (--gateway-rtt): each sample is a handshake the gateway
+/// sees aborted before TLS, which concentrators log or rate-limit. Without it
+/// the gateway is only resolved, which still warms the resolver cache.
+enum GatewayProbe {
+
+  /// Shortest interval accepted between handshakes.
+  static let minimumInterval: Duration = .seconds(10)
+
+  private static let latestSample = Mutex<Duration?>(nil)
+
+  /// The most recent round-trip time, if any handshake has completed.
+  static var latest: Duration? {
+    latestSample.withLock { $0 }
+  }
+
+  /// Resolves `host` in the background and, given an `interval`, samples
+  /// the round-trip time that often.
+  static func start(host: String, port: UInt16, interval: Duration?) {
+    Threads.detach(name: "rtt") {
+      let address: String
+      do {
+        address = try Sockets.resolve(host: host, port: port)
+      } catch {
+        print("⚠️  Warning: Gateway RTT unavailable: \(error)")
+        return
+      }
+      StatsSegment.publish(gateway: address)
+      guard let interval else { return }
+
+      let clock = ContinuousClock()
+      while true {
+        let started = clock.now
+        if let fd = try? Sockets.openConnection(host: address, port: port) {
+          let rtt = started.duration(to: clock.now)
+          close(fd)
+          latestSample.withLock { $0 = rtt }
+          StatsSegment.publish(rtt: rtt)
+        }
+        Threads.sleep(interval)
+      }
+    }
+  }
+}
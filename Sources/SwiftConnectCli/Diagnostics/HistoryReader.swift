@@ -0,0 +1,127 @@
+//
+//  HistoryReader.swift
+//  SwiftConnectCli
+//
+//  Decoder and downsampler for files written by HistoryStore
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Reads a history file back into samples and aggregates them into buckets.
+struct HistoryReader {
+
+  /// Error thrown when a file is not a valid history file.
+  struct FormatError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Traffic moved during `interval` up to `time`.
+  struct Row {
+    let time: Date
+    let interval: Double
+    let rxBytes: UInt64
+    let txBytes: UInt64
+    let rxPackets: UInt64
+    let txPackets: UInt64
+    let rtt: Duration?
+  }
+
+  /// Aggregate of the rows in one time step.
+  struct Bucket {
+    let start: Date
+    var covered: Double = 0
+    var rxBytes: UInt64 = 0
+    var txBytes: UInt64 = 0
+    var rtts: [Duration] = []
+
+    var rxRate: Double? { covered > 0 ? Double(rxBytes) / covered : nil }
+    var txRate: Double? { covered > 0 ? Double(txBytes) / covered : nil }
+  }
+
+  /// Every row in the file, oldest first.
+  let rows: [Row]
+
+  init(data: Data) throws {
+    let bytes = [UInt8](data)
+    guard bytes.count >= HistoryStore.headerSize, bytes.starts(with: HistoryStore.magic) else {
+      throw FormatError(description: "Not a history file")
+    }
+
+    let (version, blockSize, blockCount) = bytes.withUnsafeBytes {
+      (
+        HistoryStore.load32($0, at: 4), Int(HistoryStore.load32($0, at: 8)),
+        Int(HistoryStore.load32($0, at: 12))
+      )
+    }
+    guard version == HistoryStore.version else {
+      throw FormatError(description: "Unsupported history file version \(version)")
+    }
+    guard blockSize > HistoryStore.blockHeaderSize,
+      bytes.count >= HistoryStore.headerSize + blockCount * blockSize
+    else {
+      throw FormatError(description: "Truncated history file")
+    }
+
+    var rows: [Row] = []
+    for block in 0..<blockCount {
+      let start = HistoryStore.headerSize + block * blockSize
+      let (base, used) = bytes.withUnsafeBytes {
+        (
+          UInt64(littleEndian: $0.loadUnaligned(fromByteOffset: start, as: UInt64.self)),
+          Int(HistoryStore.load32($0, at: start + 8))
+        )
+      }
+      guard base > 0, used <= blockSize - HistoryStore.blockHeaderSize else { continue }
+
+      let bodyStart = start + HistoryStore.blockHeaderSize
+      let body = bytes[bodyStart..<(bodyStart + used)]
+      var offset = body.startIndex
+      var time = Double(base) / 1e9
+      while offset < body.endIndex {
+        guard let interval = Varint.read(body, at: &offset),
+          let rxBytes = Varint.read(body, at: &offset),
+          let txBytes = Varint.read(body, at: &offset),
+          let rxPackets = Varint.read(body, at: &offset),
+          let txPackets = Varint.read(body, at: &offset),
+          let rtt = Varint.read(body, at: &offset)
+        else {
+          throw FormatError(description: "Truncated row in block \(block)")
+        }
+        time += Double(interval) / 1e3
+        rows.append(
+          Row(
+            time: Date(timeIntervalSince1970: time),
+            interval: Double(interval) / 1e3,
+            rxBytes: rxBytes, txBytes: txBytes, rxPackets: rxPackets, txPackets: txPackets,
+            rtt: rtt > 0 ? .microseconds(rtt - 1) : nil))
+      }
+    }
+
+    // Blocks are reused round-robin; order rows by time instead of position
+    self.rows = rows.sorted { $0.time < $1.time }
+  }
+
+  /// Aggregates rows from `since` up to `until` into buckets of `step`
+  /// seconds. Rates cover only the time samples were taken, so gaps while no
+  /// session ran do not dilute them.
+  func buckets(since: Date, until: Date, step: Double) -> [Bucket] {
+    let count = max(Int((until.timeIntervalSince(since) / step).rounded(.up)), 0)
+    var buckets = (0..<count).map { Bucket(start: since.addingTimeInterval(Double($0) * step)) }
+
+    for row in rows where row.time >= since && row.time < until {
+      let index = Int(row.time.timeIntervalSince(since) / step)
+      guard index < buckets.count else { continue }
+      buckets[index].covered += row.interval
+      buckets[index].rxBytes += row.rxBytes
+      buckets[index].txBytes += row.txBytes
+      if let rtt = row.rtt {
+        buckets[index].rtts.append(rtt)
+      }
+    }
+    return buckets
+  }
+}
@@ -0,0 +1,208 @@
+//
+//  HistoryStore.swift
+//  SwiftConnectCli
+//
+//  Fixed-size ring file of traffic and RTT samples
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Appends statistics samples to a memory-mapped ring file.
+///
+/// The file is divided into fixed-size blocks used round-robin, so its size
+/// is the retention: when the last block is full, the oldest is reused. Each
+/// sample is stored as a row of varints holding deltas: time since the
+/// previous sample, the bytes and packets moved since then in each direction,
+/// and the gateway RTT. A row takes around a dozen bytes. Appending only
+/// writes to mapped memory; the kernel writes pages back on its own schedule.
+/// `swiftconnect-cli history` reads the file.
+///
+/// File layout, integers little-endian: the 64-byte header `"SCTS" | u32
+/// version | u32 block size | u32 block count | u32 current block`, then the
+/// blocks. A block starts with `u64 base_realtime_ns | u32 used | u32 rows`
+/// followed by `used` bytes of rows:
+///
+///   varint interval (ms) | varint rx bytes | varint tx bytes |
+///   varint rx packets | varint tx packets | varint rtt (µs + 1, 0 = none)
+///
+/// Row times accumulate intervals from the block's base time, which is the
+/// time of the sample before its first row. An interval of zero marks the
+/// first sample of a session, whose deltas are zero.
+final class HistoryStore: Sendable {
+
+  static let magic = Array("SCTS".utf8)
+  static let version: UInt32 = 1
+  static let headerSize = 64
+  static let blockHeaderSize = 16
+  static let blockSize = 4096
+
+  /// Path `swiftconnect-cli history` reads unless told otherwise.
+  static let defaultPath = "/var/tmp/swiftconnect-cli.scts"
+
+  /// Error thrown when the file cannot be created or is incompatible.
+  struct FileError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  private struct State: ~Copyable {
+    let mapping: UnsafeMutableRawPointer
+    let blockCount: Int
+    var block: Int
+    var lastRowTime: UInt64
+    var lastSample: TrafficSample?
+    var scratch: [UInt8] = []
+  }
+
+  private let state: Mutex<State>
+
+  /// Opens or creates a store of `size` bytes at `path`. An existing store
+  /// must have the same size; it is locked for the life of the process.
+  init(path: String, size: Int) throws {
+    let blockCount = (size - Self.headerSize) / Self.blockSize
+    guard blockCount >= 2 else {
+      throw FileError(
+        description: "History file size must be at least \(Self.headerSize + 2 * Self.blockSize) bytes")
+    }
+    let size = Self.headerSize + blockCount * Self.blockSize
+
+    let fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0o644)
+    guard fd >= 0 else {
+      throw FileError(
+        description: "Cannot open history file '\(path)': \(String(cString: strerror(errno)))")
+    }
+    // The mapping keeps the file open; the descriptor only holds the lock
+    guard flock(fd, LOCK_EX | LOCK_NB) == 0 else {
+      Posix.close(fd)
+      throw FileError(description: "History file '\(path)' is in use by another session")
+    }
+
+    var info = stat()
+    fstat(fd, &info)
+    let isNew = info.st_size == 0
+    guard isNew || Int(info.st_size) == size else {
+      Posix.close(fd)
+      throw FileError(
+        description: "History file '\(path)' has a different size; remove it or pass the size it was created with"
+      )
+    }
+
+    guard !isNew || ftruncate(fd, off_t(size)) == 0,
+      let mapping = mmap(nil, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0),
+      mapping != UnsafeMutableRawPointer(bitPattern: -1)
+    else {
+      let error = FileError(
+        description: "Cannot map history file '\(path)': \(String(cString: strerror(errno)))")
+      Posix.close(fd)
+      throw error
+    }
+
+    let header = UnsafeRawBufferPointer(start: mapping, count: Self.headerSize)
+    if isNew {
+      var bytes = Self.magic
+      withUnsafeBytes(of: Self.version.littleEndian) { bytes += $0 }
+      withUnsafeBytes(of: UInt32(Self.blockSize).littleEndian) { bytes += $0 }
+      withUnsafeBytes(of: UInt32(blockCount).littleEndian) { bytes += $0 }
+      withUnsafeBytes(of: UInt32(0).littleEndian) { bytes += $0 }
+      bytes.withUnsafeBytes { mapping.copyMemory(from: $0.baseAddress!, byteCount: $0.count) }
+    } else {
+      guard header.starts(with: Self.magic),
+        Self.load32(header, at: 4) == Self.version,
+        Self.load32(header, at: 8) == UInt32(Self.blockSize),
+        Self.load32(header, at: 12) == UInt32(blockCount)
+      else {
+        munmap(mapping, size)
+        Posix.close(fd)
+        throw FileError(description: "'\(path)' is not a compatible history file")
+      }
+    }
+
+    // A new session starts a fresh block after the last one written
+    let current = isNew ? -1 : Int(Self.load32(header, at: 16))
+    state = Mutex(
+      State(
+        mapping: mapping, blockCount: blockCount, block: current, lastRowTime: 0))
+    state.withLock { Self.startBlock(after: $0.block, at: Self.realtimeNanoseconds(), in: &$0) }
+  }
+
+  /// Appends a sample with the latest gateway round-trip time, if any.
+  func append(_ sample: TrafficSample, rtt: Duration?) {
+    let now = Self.realtimeNanoseconds()
+
+    state.withLock { state in
+      state.scratch.removeAll(keepingCapacity: true)
+
+      // Deltas against the previous sample; counters restart after reconnects
+      let delta = { (current: UInt64, previous: UInt64) in
+        current >= previous ? current - previous : current
+      }
+      if let last = state.lastSample {
+        let interval = UInt64(max(Units.seconds(last.time.duration(to: sample.time)) * 1e3, 1))
+        Varint.append(interval, to: &state.scratch)
+        Varint.append(delta(sample.rxBytes, last.rxBytes), to: &state.scratch)
+        Varint.append(delta(sample.txBytes, last.txBytes), to: &state.scratch)
+        Varint.append(delta(sample.rxPackets, last.rxPackets), to: &state.scratch)
+        Varint.append(delta(sample.txPackets, last.txPackets), to: &state.scratch)
+      } else {
+        state.scratch += [0, 0, 0, 0, 0]
+      }
+      let rttMicroseconds = rtt.map { UInt64(max(Units.seconds($0) * 1e6, 0)) + 1 } ?? 0
+      Varint.append(rttMicroseconds, to: &state.scratch)
+      state.lastSample = sample
+
+      let blockStart = state.mapping + Self.headerSize + state.block * Self.blockSize
+      var used = Int(blockStart.loadUnaligned(fromByteOffset: 8, as: UInt32.self).littleEndian)
+      if Self.blockHeaderSize + used + state.scratch.count > Self.blockSize {
+        // Base the next block on this row's predecessor so its interval still applies
+        Self.startBlock(after: state.block, at: state.lastRowTime, in: &state)
+        used = 0
+      }
+
+      let block = state.mapping + Self.headerSize + state.block * Self.blockSize
+      let rows = block.loadUnaligned(fromByteOffset: 12, as: UInt32.self).littleEndian
+      state.scratch.withUnsafeBytes {
+        (block + Self.blockHeaderSize + used).copyMemory(from: $0.baseAddress!, byteCount: $0.count)
+      }
+      // Counts are updated after the row so a torn write is never read back
+      block.storeBytes(
+        of: UInt32(used + state.scratch.count).littleEndian, toByteOffset: 8, as: UInt32.self)
+      block.storeBytes(of: (rows + 1).littleEndian, toByteOffset: 12, as: UInt32.self)
+      state.lastRowTime = now
+    }
+  }
+
+  // MARK: - Private
+
+  private static func startBlock(after block: Int, at baseTime: UInt64, in state: inout State) {
+    state.block = (block + 1) % state.blockCount
+    state.lastRowTime = baseTime
+
+    let start = state.mapping + headerSize + state.block * blockSize
+    start.initializeMemory(as: UInt8.self, repeating: 0, count: blockSize)
+    start.storeBytes(of: baseTime.littleEndian, toByteOffset: 0, as: UInt64.self)
+    state.mapping.storeBytes(of: UInt32(state.block).littleEndian, toByteOffset: 16, as: UInt32.self)
+  }
+
+  static func load32(_ bytes: UnsafeRawBufferPointer, at offset: Int) -> UInt32 {
+    UInt32(littleEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+  }
+
+  static func realtimeNanoseconds() -> UInt64 {
+    var now = timespec()
+    clock_gettime(CLOCK_REALTIME, &now)
+    return UInt64(now.tv_sec) * 1_000_000_000 + UInt64(now.tv_nsec)
+  }
+}
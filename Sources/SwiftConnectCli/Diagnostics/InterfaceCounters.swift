@@ -0,0 +1,127 @@
+//
+//  InterfaceCounters.swift
+//  SwiftConnectCli
+//
+//  Synchronous reads of the tunnel interface's kernel traffic counters
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Cumulative tunnel traffic at one instant.
+struct TrafficSample {
+  let time: ContinuousClock.Instant
+  let rxBytes: UInt64
+  let txBytes: UInt64
+  let rxPackets: UInt64
+  let txPackets: UInt64
+}
+
+/// Reads the counters the kernel keeps for the TUN device.
+///
+/// Every packet libopenconnect moves through the tunnel crosses the TUN
+/// device, whose counters the kernel updates per packet without any help from
+/// the session. Reading them is synchronous and costs a few system calls, so
+/// samples can be taken at any moment and stamped with the monotonic clock
+/// for exact rates. Received means from the VPN into the host.
+final class InterfaceCounters {
+
+  let interface: String
+
+  #if os(Linux)
+    // rx_bytes, tx_bytes, rx_packets, tx_packets, kept open and re-read with pread
+    private let files: [Int32]
+  #else
+    // if_data counters are 32 bits wide; wraps are folded into 64-bit totals
+    private var totals = [UInt64](repeating: 0, count: 4)
+    private var last: [UInt32]?
+  #endif
+
+  /// Returns nil if the interface does not exist in this network namespace.
+  init?(interface: String) {
+    self.interface = interface
+
+    #if os(Linux)
+      var files: [Int32] = []
+      for name in ["rx_bytes", "tx_bytes", "rx_packets", "tx_packets"] {
+        let fd = open("/sys/class/net/\(interface)/statistics/\(name)", O_RDONLY | O_CLOEXEC)
+        guard fd >= 0 else {
+          files.forEach { _ = close($0) }
+          return nil
+        }
+        files.append(fd)
+      }
+      self.files = files
+    #endif
+
+    guard sample() != nil else { return nil }
+  }
+
+  deinit {
+    #if os(Linux)
+      files.forEach { _ = close($0) }
+    #endif
+  }
+
+  /// Current counters, or nil once the interface has gone away.
+  func sample() -> TrafficSample? {
+    #if os(Linux)
+      var values: [UInt64] = []
+      var buffer = [UInt8](repeating: 0, count: 32)
+      for fd in files {
+        let count = pread(fd, &buffer, buffer.count, 0)
+        guard count > 0 else { return nil }
+        let text = String(decoding: buffer[..<count], as: UTF8.self)
+        guard let value = UInt64(text.filter(\.isNumber)) else {
+          return nil
+        }
+        values.append(value)
+      }
+    #else
+      guard let raw = Self.linkCounters(interface) else { return nil }
+      if let last {
+        for index in 0..<4 {
+          totals[index] += UInt64(raw[index] &- last[index])
+        }
+      } else {
+        totals = raw.map(UInt64.init)
+      }
+      last = raw
+      let values = totals
+    #endif
+
+    return TrafficSample(
+      time: .now, rxBytes: values[0], txBytes: values[1], rxPackets: values[2],
+      txPackets: values[3])
+  }
+
+  #if !os(Linux)
+    private static func linkCounters(_ interface: String) -> [UInt32]? {
+      var list: UnsafeMutablePointer<ifaddrs>?
+      guard getifaddrs(&list) == 0 else { return nil }
+      defer { freeifaddrs(list) }
+
+      var entry = list
+      while let current = entry {
+        defer { entry = current.pointee.ifa_next }
+        guard String(cString: current.pointee.ifa_name) == interface,
+          current.pointee.ifa_addr?.pointee.sa_family == sa_family_t(AF_LINK),
+          let data = current.pointee.ifa_data?.assumingMemoryBound(to: if_data.self).pointee
+        else { continue }
+        return [data.ifi_ibytes, data.ifi_obytes, data.ifi_ipackets, data.ifi_opackets]
+      }
+      return nil
+    }
+  #endif
+}
@@ -0,0 +1,41 @@
+//
+//  LogLevel+Rank.swift
+//  SwiftConnectCli
+//
+//  Numeric ordering of log levels for filtering and binary records
+//
+
+import OpenConnectKit
+
+extension LogLevel {
+
+  /// 0 for errors up to 3 for trace; higher is more verbose.
+  var rank: UInt8 {
+    switch self {
+    case .error: return 0
+    case .info: return 1
+    case .debug: return 2
+    case .trace: return 3
+    }
+  }
+
+  /// Label used when printing a record of this level.
+  var label: String {
+    switch self {
+    case .error: return "ERROR"
+    case .info: return "INFO"
+    case .debug: return "DEBUG"
+    case .trace: return "TRACE"
+    }
+  }
+
+  /// The level with the given rank, clamping unknown values to trace.
+  init(rank: UInt8) {
+    switch rank {
+    case 0: self = .error
+    case 1: self = .info
+    case 2: self = .debug
+    default: self = .trace
+    }
+  }
+}
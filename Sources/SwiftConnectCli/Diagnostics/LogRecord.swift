@@ -0,0 +1,22 @@
+//
+//  LogRecord.swift
+//  SwiftConnectCli
+//
+//  A decoded record from one of the CLI's binary log files
+//
+
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// One log line or event read back from a flight recording or binary log.
+struct LogRecord {
+  let time: Date
+  let isEvent: Bool
+  let level: LogLevel
+  let message: String
+}
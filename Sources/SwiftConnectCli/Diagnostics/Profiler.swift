@@ -0,0 +1,220 @@
+//
+//  Profiler.swift
+//  SwiftConnectCli
+//
+//  Built-in sampling profiler writing folded stacks
+//
+
+import CSwiftConnectSupport
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Samples the session's own stacks for a while and writes folded stacks.
+///
+/// Sampling is driven by the process CPU-time timer, so busy threads are
+/// sampled in proportion to the CPU they use and idle ones not at all. Stacks
+/// are unwound through frame pointers in the signal handler (see profiler.h).
+///
+/// The output is one line per distinct stack, `thread;outer;…;inner count`,
+/// as read by flamegraph.pl, speedscope and inferno. Frames are written as
+/// `module+0xoffset` rather than symbol names, so nothing is symbolized on
+/// the production host; `scripts/symbolize-folded.sh` resolves them against
+/// the same binaries later. Return addresses are written minus one so they
+/// resolve to the call instruction rather than the one after it.
+enum Profiler {
+
+  /// Error thrown when a profile cannot be taken or written.
+  struct ProfileError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Outcome of one run.
+  struct Summary: CustomStringConvertible {
+    let path: String
+    let duration: Duration
+    let samples: Int
+    let dropped: Int
+    let stacks: Int
+
+    var description: String {
+      var text =
+        "Profiled \(Units.elapsed(duration)): \(samples) samples, \(stacks) distinct stacks written to \(path)"
+      if dropped > 0 {
+        text += " (\(dropped) samples dropped, buffer full)"
+      }
+      return text
+    }
+  }
+
+  static let defaultFrequency = 99
+  static let maximumDuration: Duration = .seconds(600)
+
+  /// Upper bound on buffered samples, about 17 MiB.
+  private static let maximumSamples = 32_768
+
+  /// Held from start until the samples are folded; the next start frees them.
+  private static let busy = Mutex(false)
+
+  /// Profiles for `duration` at `frequency` Hz of CPU time and writes the
+  /// folded stacks to `path`. Blocks for the duration; one run at a time.
+  static func run(duration: Duration, frequency: Int, path: String) throws -> Summary {
+    guard duration > .zero, duration <= maximumDuration else {
+      throw ProfileError(
+        description: "Duration must be between 0 and \(Units.elapsed(maximumDuration))")
+    }
+    guard (1...1000).contains(frequency) else {
+      throw ProfileError(description: "Frequency must be between 1 and 1000 Hz")
+    }
+
+    // Control clients and SIGUSR2 each profile on their own thread
+    guard busy.withLock({ running in defer { running = true }; return !running }) else {
+      throw ProfileError(description: "A profile is already running")
+    }
+    defer { busy.withLock { $0 = false } }
+
+    // Every core can be busy at once; the buffer is allocated before the timer starts
+    let expected =
+      Units.seconds(duration) * Double(frequency) * Double(ProcessInfo.processInfo.activeProcessorCount)
+    let capacity = min(Int(expected.rounded(.up)) + 16, maximumSamples)
+
+    // Names of threads that exit during the run are only seen here
+    var threadNames = threadNamesByID()
+
+    guard scs_profiler_start(UInt32(frequency), capacity) == 0 else {
+      if errno == EBUSY {
+        throw ProfileError(description: "A profile is already running")
+      }
+      throw ProfileError(description: "Cannot start profiler: \(String(cString: strerror(errno)))")
+    }
+    Threads.sleep(duration)
+    var dropped = 0
+    let taken = scs_profiler_stop(&dropped)
+
+    threadNames.merge(threadNamesByID()) { _, current in current }
+    let folded = fold(samples: taken, threadNames: threadNames)
+
+    // Heaviest stacks first so a truncated file still shows the hot spots
+    var output = ""
+    for (stack, count) in folded.sorted(by: { $0.value > $1.value }) {
+      output += "\(stack) \(count)\n"
+    }
+
+    let fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0o600)
+    guard fd >= 0 else {
+      throw ProfileError(
+        description: "Cannot create profile '\(path)': \(String(cString: strerror(errno)))")
+    }
+    defer { close(fd) }
+    let bytes = Array(output.utf8)
+    guard Sockets.writeAll(fd, bytes, bytes.count) else {
+      throw ProfileError(
+        description: "Cannot write profile '\(path)': \(String(cString: strerror(errno)))")
+    }
+
+    return Summary(
+      path: path,
+      duration: duration,
+      samples: folded.values.reduce(0, +),
+      dropped: dropped,
+      stacks: folded.count
+    )
+  }
+
+  /// Control socket command: `profile <seconds> <frequency> <path>`.
+  static func handle(_ arguments: [String]) throws -> String {
+    guard arguments.count == 3, let seconds = Double(arguments[0]),
+      let frequency = Int(arguments[1])
+    else {
+      throw ControlServer.CommandError(description: "Usage: profile <seconds> <frequency> <path>")
+    }
+    // "inf", "nan" and "1e300" parse too; converting them would trap
+    guard seconds.isFinite, seconds > 0, seconds <= Units.seconds(maximumDuration) else {
+      throw ControlServer.CommandError(
+        description: "Duration must be between 0 and \(Units.elapsed(maximumDuration))")
+    }
+    do {
+      return try run(
+        duration: .milliseconds(Int64(seconds * 1000)), frequency: frequency, path: arguments[2]
+      ).description
+    } catch {
+      throw ControlServer.CommandError(description: "\(error)")
+    }
+  }
+
+  /// File name for a profile triggered by a signal.
+  static func path(in directory: String) -> String {
+    "\(directory)/swiftconnect-cli-\(getpid())-profile-\(time(nil)).folded"
+  }
+
+  // MARK: - Private
+
+  private static func fold(samples count: Int, threadNames: [UInt64: String]) -> [String: Int] {
+    guard let samples = scs_profiler_samples() else { return [:] }
+
+    var frameNames: [UInt64: String] = [:]
+    var folded: [String: Int] = [:]
+
+    for sample in UnsafeBufferPointer(start: samples, count: count) {
+      let depth = Int(sample.depth)
+      guard depth > 0 else { continue }
+
+      var frames = [threadNames[sample.thread_id] ?? "thread-\(sample.thread_id)"]
+      withUnsafeBytes(of: sample.frames) { raw in
+        let addresses = raw.bindMemory(to: UInt64.self)
+        for index in (0..<depth).reversed() {
+          let address = index == 0 ? addresses[index] : addresses[index] &- 1
+          if let name = frameNames[address] {
+            frames.append(name)
+          } else {
+            let name = frameName(address)
+            frameNames[address] = name
+            frames.append(name)
+          }
+        }
+      }
+      folded[frames.joined(separator: ";"), default: 0] += 1
+    }
+    return folded
+  }
+
+  private static func frameName(_ address: UInt64) -> String {
+    var module: UnsafePointer<CChar>?
+    var offset: UInt64 = 0
+    guard scs_profiler_module(address, &module, &offset) == 0, let module else {
+      return "0x" + String(address, radix: 16)
+    }
+    // Semicolons and spaces would break the folded format
+    let path = String(cString: module).map { $0 == ";" || $0 == " " ? "_" : $0 }
+    return String(path) + "+0x" + String(offset, radix: 16)
+  }
+
+  private static func threadNamesByID() -> [UInt64: String] {
+    #if os(Linux)
+      let tasks = (try? FileManager.default.contentsOfDirectory(atPath: "/proc/self/task")) ?? []
+      var names: [UInt64: String] = [:]
+      for task in tasks {
+        guard let id = UInt64(task),
+          let comm = try? String(contentsOfFile: "/proc/self/task/\(task)/comm", encoding: .utf8)
+        else { continue }
+        names[id] = String(
+          comm.filter { !$0.isNewline }.map { $0 == ";" || $0 == " " ? "_" : $0 })
+      }
+      return names
+    #else
+      return [:]
+    #endif
+  }
+}
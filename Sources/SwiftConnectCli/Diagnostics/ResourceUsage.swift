@@ -0,0 +1,174 @@
+//
+//  ResourceUsage.swift
+//  SwiftConnectCli
+//
+//  The CLI's own CPU, memory, context switch and page fault accounting
+//
+
+import CSwiftConnectSupport
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// A snapshot of what this process has consumed so far.
+///
+/// On Linux every thread is read from /proc/self/task, so CPU time and
+/// context switches can be attributed to the data path, logging and timer
+/// threads by name. Voluntary context switches are the thread blocking and
+/// being woken again, i.e. wakeups. Elsewhere only process totals from
+/// getrusage are available.
+struct ResourceUsage {
+
+  struct ThreadUsage {
+    let id: Int32
+    let name: String
+    let cpu: Duration
+    let voluntarySwitches: UInt64
+    let involuntarySwitches: UInt64
+  }
+
+  let time: ContinuousClock.Instant
+  let threads: [ThreadUsage]
+  let cpu: Duration
+  let voluntarySwitches: UInt64
+  let involuntarySwitches: UInt64
+  let minorFaults: UInt64
+  let majorFaults: UInt64
+  let residentBytes: UInt64
+  let heapBytes: UInt64
+
+  /// Reads the current usage of this process.
+  static func sample() -> ResourceUsage {
+    let time = ContinuousClock.now
+    var usage = rusage()
+    getrusage(RUSAGE_SELF, &usage)
+    let processCpu =
+      Duration.seconds(Int64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec))
+      + .microseconds(Int64(usage.ru_utime.tv_usec) + Int64(usage.ru_stime.tv_usec))
+
+    #if os(Linux)
+      let threads = linuxThreads()
+    #else
+      let threads: [ThreadUsage] = []
+    #endif
+
+    return ResourceUsage(
+      time: time,
+      threads: threads,
+      cpu: processCpu,
+      voluntarySwitches: UInt64(usage.ru_nvcsw),
+      involuntarySwitches: UInt64(usage.ru_nivcsw),
+      minorFaults: UInt64(usage.ru_minflt),
+      majorFaults: UInt64(usage.ru_majflt),
+      residentBytes: scs_resident_bytes(),
+      heapBytes: scs_heap_in_use()
+    )
+  }
+
+  #if os(Linux)
+    private static let clockTicks = Double(sysconf(Int32(_SC_CLK_TCK)))
+
+    private static func linuxThreads() -> [ThreadUsage] {
+      let tasks = (try? FileManager.default.contentsOfDirectory(atPath: "/proc/self/task")) ?? []
+      return tasks.compactMap { task -> ThreadUsage? in
+        guard let id = Int32(task), let stat = read("/proc/self/task/\(task)/stat"),
+          let open = stat.firstIndex(of: "("), let close = stat.lastIndex(of: ")")
+        else { return nil }
+
+        // Fields after the parenthesised name start with field 3 (state);
+        // utime and stime are fields 14 and 15, in clock ticks
+        let fields = stat[stat.index(after: close)...].split(separator: " ")
+        guard fields.count > 12, let user = Double(fields[11]), let system = Double(fields[12])
+        else { return nil }
+
+        var voluntary: UInt64 = 0
+        var involuntary: UInt64 = 0
+        for line in read("/proc/self/task/\(task)/status")?.split(separator: "\n") ?? [] {
+          if line.hasPrefix("voluntary_ctxt_switches:") {
+            voluntary = UInt64(line.split(separator: "\t").last ?? "") ?? 0
+          } else if line.hasPrefix("nonvoluntary_ctxt_switches:") {
+            involuntary = UInt64(line.split(separator: "\t").last ?? "") ?? 0
+          }
+        }
+
+        return ThreadUsage(
+          id: id,
+          name: String(stat[stat.index(after: open)..<close]),
+          cpu: .seconds((user + system) / clockTicks),
+          voluntarySwitches: voluntary,
+          involuntarySwitches: involuntary
+        )
+      }
+    }
+
+    private static func read(_ path: String) -> String? {
+      FileManager.default.contents(atPath: path).map { String(decoding: $0, as: UTF8.self) }
+    }
+  #endif
+}
+
+/// Rates between two usage samples.
+struct ResourceRates {
+
+  struct ThreadRate {
+    let name: String
+    /// Fraction of one CPU, e.g. 0.05 for 5%.
+    let cpu: Double
+    let wakeupsPerSecond: Double
+  }
+
+  let cpu: Double
+  let wakeupsPerSecond: Double
+  /// Minor page faults, mostly first touches of fresh memory.
+  let faultsPerSecond: Double
+  let cpuTime: Duration
+  /// Busiest threads first; threads named alike (one per connection) are merged.
+  let threads: [ThreadRate]
+
+  init?(from previous: ResourceUsage, to current: ResourceUsage) {
+    let elapsed = Units.seconds(previous.time.duration(to: current.time))
+    guard elapsed > 0 else { return nil }
+
+    cpuTime = current.cpu - previous.cpu
+    cpu = Units.seconds(cpuTime) / elapsed
+    wakeupsPerSecond =
+      Double(current.voluntarySwitches &- previous.voluntarySwitches) / elapsed
+    faultsPerSecond = Double(current.minorFaults &- previous.minorFaults) / elapsed
+
+    // Threads that exited in between are dropped; new ones count from zero
+    let before = Dictionary(previous.threads.map { ($0.id, $0) }, uniquingKeysWith: { $1 })
+    var byName: [String: (cpu: Duration, wakeups: UInt64)] = [:]
+    for thread in current.threads {
+      let earlier = before[thread.id]
+      let cpu = thread.cpu - (earlier?.cpu ?? .zero)
+      let wakeups = thread.voluntarySwitches &- (earlier?.voluntarySwitches ?? 0)
+      let name = Self.group(thread.name)
+      byName[name, default: (.zero, 0)].cpu += cpu
+      byName[name, default: (.zero, 0)].wakeups += wakeups
+    }
+
+    threads = byName.map { name, usage in
+      ThreadRate(
+        name: name, cpu: Units.seconds(usage.cpu) / elapsed,
+        wakeupsPerSecond: Double(usage.wakeups) / elapsed)
+    }
+    .sorted { $0.cpu > $1.cpu || ($0.cpu == $1.cpu && $0.wakeupsPerSecond > $1.wakeupsPerSecond) }
+  }
+
+  // Per-connection forwarding threads ("fwd-8080-c", "fwd-8080-u") are grouped by forward
+  private static func group(_ name: String) -> String {
+    guard name.hasPrefix("fwd-") else { return name }
+    return name.split(separator: "-").prefix(2).joined(separator: "-")
+  }
+}
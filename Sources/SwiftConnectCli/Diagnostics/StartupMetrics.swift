@@ -0,0 +1,131 @@
+//
+//  StartupMetrics.swift
+//  SwiftConnectCli
+//
+//  Time from exec to the tunnel connecting and carrying its first packet
+//
+
+import CSwiftConnectSupport
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Measures start-up from the user's point of view: from exec, including
+/// dynamic loading, to `.connected` and then to the first packet forwarded
+/// over the tunnel in either direction.
+///
+/// The exec time is handed over by a benchmark harness when it sets
+/// SWIFTCONNECT_EXEC_REALTIME_NS, and otherwise comes from the kernel's process
+/// start time, which is only good to 10 ms (see startup.h). Where neither is
+/// available the clock starts at the C constructors instead.
+/// The first packet is seen by polling the TUN device's counters, so it is
+/// only reported when the interface is visible to this process.
+///
+/// Along the way the start-up path marks its phases. With --startup-trace
+/// they are printed at `.connected`, relative to exec, together with a
+/// `startup-trace` line for scripts/bench-startup.sh.
+enum StartupMetrics {
+
+  /// Start of the process on the CLOCK_MONOTONIC scale. Never after the C
+  /// constructors, so no phase comes out negative.
+  static let origin: UInt64 = {
+    let exec = scs_startup_exec_ns()
+    let constructor = scs_startup_constructor_ns()
+    return exec > 0 ? min(exec, constructor) : constructor
+  }()
+
+  /// Time elapsed since the process started.
+  static func sinceExec() -> Duration {
+    .nanoseconds(max(Int64(bitPattern: scs_monotonic_ns() &- origin), 0))
+  }
+
+  /// Records that start-up reached `phase`.
+  static func mark(_ phase: String) {
+    let now = scs_monotonic_ns()
+    marks.withLock { $0.append((phase, now)) }
+  }
+
+  /// Prints the phases at `.connected`.
+  static func enableTrace() {
+    traceEnabled.store(true, ordering: .relaxed)
+  }
+
+  /// Reports time to connect and starts watching for the first packet. Only
+  /// the first connection counts; reconnects are not start-up.
+  static func reportConnected(monitor: TrafficMonitor?) {
+    guard !reported.exchange(true, ordering: .relaxed) else { return }
+
+    mark("connected")
+    let connected = sinceExec()
+    print("[\(Timestamp.time())] ⏱  Time to connect: \(Units.milliseconds(connected)) since start")
+    FlightRecorder.record(event: "connected \(Units.milliseconds(connected)) after exec")
+    if traceEnabled.load(ordering: .relaxed) {
+      printTrace()
+    }
+
+    // Fine-grained polling is for benchmarks; otherwise a 2 ms poll would be
+    // 500 wakeups/s on an idle tunnel for up to a minute
+    guard let monitor else { return }
+    let interval = traceEnabled.load(ordering: .relaxed) ? tracePollInterval : pollInterval
+    Threads.detach(name: "first-packet") {
+      let deadline = connected + firstPacketTimeout
+      while sinceExec() < deadline {
+        // No counters means no interface here (userspace stack, --netns)
+        guard let sample = monitor.sample() else { return }
+        if sample.rxPackets + sample.txPackets > 0 {
+          let elapsed = sinceExec()
+          print("[\(Timestamp.time())] ⏱  Time to first packet: \(Units.milliseconds(elapsed)) since start")
+          FlightRecorder.record(event: "first packet \(Units.milliseconds(elapsed)) after exec")
+          return
+        }
+        Threads.sleep(interval)
+      }
+    }
+  }
+
+  // MARK: - Private
+
+  // Loading and relocating shared libraries ends at the C constructors
+  private static func printTrace() {
+    var phases = [("load+relocate", scs_startup_constructor_ns())]
+    phases += marks.withLock { $0 }
+
+    print("⏱  Start-up trace (ms since exec):")
+    var machine = "startup-trace"
+    var previous = origin
+    for (phase, time) in phases {
+      let total = milliseconds(time &- origin)
+      let step = milliseconds(time &- previous)
+      print("     \(Units.column(phase, width: 16)) \(total)  (+\(step))")
+      machine += " \(phase)=\(total)"
+      previous = time
+    }
+    print(machine)
+    // scripts/bench-startup.sh waits for this line before stopping the session
+    fflush(stdout)
+  }
+
+  // Differences that wrapped below zero are shown as zero
+  private static func milliseconds(_ nanoseconds: UInt64) -> String {
+    Units.decimal(Double(max(Int64(bitPattern: nanoseconds), 0)) / 1e6, places: 3)
+  }
+
+  private static let marks = Mutex<[(String, UInt64)]>([])
+  private static let traceEnabled = Atomic<Bool>(false)
+  private static let reported = Atomic<Bool>(false)
+  private static let pollInterval: Duration = .milliseconds(25)
+  private static let tracePollInterval: Duration = .milliseconds(2)
+  private static let firstPacketTimeout: Duration = .seconds(60)
+}
@@ -0,0 +1,269 @@
+//
+//  StatsSegment.swift
+//  SwiftConnectCli
+//
+//  Publishes live session state in shared memory for other processes
+//
+
+import CSwiftConnectSupport
+import OpenConnectKit
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// The session's live state in a POSIX shared-memory segment.
+///
+/// Status, gateway, traffic counters, rates, gateway round-trip times and the
+/// session's own resource use are written under a sequence lock whenever they
+/// change, so `swiftconnect-cli status` and monitoring agents can read them at
+/// any rate without talking to the session. See stats_segment.h for the layout.
+enum StatsSegment {
+
+  /// Error thrown when a segment cannot be created or read.
+  struct SegmentError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  private struct State {
+    var segment: UnsafeMutablePointer<scs_stats_segment>
+    var lastSample: (time: ContinuousClock.Instant, rx: UInt64, tx: UInt64)?
+  }
+
+  private static let state = Mutex<State?>(nil)
+
+  /// Creates the segment for this process; it is removed at exit.
+  static func start(server: String) throws {
+    guard let segment = scs_stats_create(getpid()) else {
+      throw SegmentError(
+        description: "Cannot create stats segment: \(String(cString: strerror(errno)))")
+    }
+
+    state.withLock { $0 = State(segment: segment) }
+    atexit { scs_stats_unlink(getpid()) }
+
+    update {
+      $0.started_ns = wallClockNanoseconds()
+      $0.status = UInt32(SCS_STATUS_CONNECTING)
+      store(server, in: &$0.server)
+    }
+  }
+
+  static func publish(status: ConnectionStatus, reconnects: Int) {
+    update {
+      $0.status = UInt32(status.code)
+      $0.reconnects = UInt32(clamping: reconnects)
+    }
+  }
+
+  static func publish(interface: String?) {
+    update { store(interface ?? "", in: &$0.interface) }
+  }
+
+  static func publish(gateway: String) {
+    update { store(gateway, in: &$0.gateway) }
+  }
+
+  /// Publishes cumulative counters; rates are derived from the previous sample
+  /// using the samples' own timestamps.
+  static func publish(_ sample: TrafficSample) {
+    updateSampling { segment, lastSample in
+      if let lastSample, sample.time > lastSample.time {
+        let elapsed = Units.seconds(lastSample.time.duration(to: sample.time))
+        // Counters restart with a new tunnel after reconnecting
+        segment.rx_rate =
+          sample.rxBytes >= lastSample.rx ? Double(sample.rxBytes - lastSample.rx) / elapsed : 0
+        segment.tx_rate =
+          sample.txBytes >= lastSample.tx ? Double(sample.txBytes - lastSample.tx) / elapsed : 0
+      }
+      lastSample = (sample.time, sample.rxBytes, sample.txBytes)
+
+      segment.rx_bytes = sample.rxBytes
+      segment.tx_bytes = sample.txBytes
+      segment.rx_packets = sample.rxPackets
+      segment.tx_packets = sample.txPackets
+    }
+  }
+
+  /// Appends a gateway round-trip time to the sample ring.
+  static func publish(rtt: Duration) {
+    let microseconds = UInt32(clamping: Int64(Units.seconds(rtt) * 1e6))
+    update { segment in
+      let index = Int(segment.rtt_count % UInt64(SCS_STATS_RTT_SAMPLES))
+      withUnsafeMutableBytes(of: &segment.rtt_us) {
+        $0.storeBytes(
+          of: microseconds, toByteOffset: index * MemoryLayout<UInt32>.stride, as: UInt32.self)
+      }
+      segment.rtt_count += 1
+    }
+  }
+
+  /// Publishes the session's own resource use.
+  static func publish(_ usage: ResourceUsage) {
+    update {
+      $0.cpu_ns = UInt64(max(Units.seconds(usage.cpu) * 1e9, 0))
+      $0.resident_bytes = usage.residentBytes
+      $0.heap_bytes = usage.heapBytes
+      $0.voluntary_switches = usage.voluntarySwitches
+      $0.involuntary_switches = usage.involuntarySwitches
+      $0.minor_faults = usage.minorFaults
+      $0.major_faults = usage.majorFaults
+      $0.threads = UInt32(usage.threads.count)
+    }
+  }
+
+  // MARK: - Writing
+
+  private static func update(_ body: (inout scs_stats_segment) -> Void) {
+    updateSampling { segment, _ in body(&segment) }
+  }
+
+  // One writer at a time; readers only ever see whole updates
+  private static func updateSampling(
+    _ body: (inout scs_stats_segment, inout (time: ContinuousClock.Instant, rx: UInt64, tx: UInt64)?)
+      -> Void
+  ) {
+    state.withLock { state in
+      guard let segment = state?.segment else { return }
+      scs_stats_write_begin(segment)
+      body(&segment.pointee, &state!.lastSample)
+      segment.pointee.updated_ns = wallClockNanoseconds()
+      scs_stats_write_end(segment)
+    }
+  }
+
+  private static func store<Field>(_ string: String, in field: inout Field) {
+    withUnsafeMutableBytes(of: &field) { buffer in
+      let bytes = Array(string.utf8.prefix(buffer.count - 1))
+      buffer.copyBytes(from: bytes)
+      for index in bytes.count..<buffer.count {
+        buffer[index] = 0
+      }
+    }
+  }
+
+  private static func wallClockNanoseconds() -> UInt64 {
+    var now = timespec()
+    clock_gettime(CLOCK_REALTIME, &now)
+    return UInt64(now.tv_sec) * 1_000_000_000 + UInt64(now.tv_nsec)
+  }
+
+  // MARK: - Reading
+
+  /// A consistent copy of another session's segment.
+  struct Snapshot {
+    let pid: Int32
+    let started: Date
+    let updated: Date
+    let status: Int32
+    let reconnects: Int
+    let server: String
+    let gateway: String
+    let interface: String
+    let rxBytes: UInt64
+    let txBytes: UInt64
+    let rxPackets: UInt64
+    let txPackets: UInt64
+    let rxRate: Double
+    let txRate: Double
+    /// Gateway round-trip times, oldest first.
+    let rtts: [Duration]
+    let cpu: Duration
+    let residentBytes: UInt64
+    let heapBytes: UInt64
+    let voluntarySwitches: UInt64
+    let involuntarySwitches: UInt64
+    let minorFaults: UInt64
+    let majorFaults: UInt64
+    let threads: Int
+
+    /// The `fraction` quantile of the round-trip samples, e.g. 0.5 for the median.
+    func rttPercentile(_ fraction: Double) -> Duration? {
+      guard !rtts.isEmpty else { return nil }
+      let sorted = rtts.sorted()
+      let index = Int((Double(sorted.count - 1) * fraction).rounded())
+      return sorted[min(max(index, 0), sorted.count - 1)]
+    }
+
+    init(_ segment: scs_stats_segment) {
+      pid = segment.pid
+      started = Date(timeIntervalSince1970: Double(segment.started_ns) / 1e9)
+      updated = Date(timeIntervalSince1970: Double(segment.updated_ns) / 1e9)
+      status = Int32(bitPattern: segment.status)
+      reconnects = Int(segment.reconnects)
+      server = StatsSegment.string(segment.server)
+      gateway = StatsSegment.string(segment.gateway)
+      interface = StatsSegment.string(segment.interface)
+      rxBytes = segment.rx_bytes
+      txBytes = segment.tx_bytes
+      rxPackets = segment.rx_packets
+      txPackets = segment.tx_packets
+      rxRate = segment.rx_rate
+      txRate = segment.tx_rate
+      cpu = .nanoseconds(Int64(clamping: segment.cpu_ns))
+      residentBytes = segment.resident_bytes
+      heapBytes = segment.heap_bytes
+      voluntarySwitches = segment.voluntary_switches
+      involuntarySwitches = segment.involuntary_switches
+      minorFaults = segment.minor_faults
+      majorFaults = segment.major_faults
+      threads = Int(segment.threads)
+
+      let capacity = UInt64(SCS_STATS_RTT_SAMPLES)
+      let count = Int(min(segment.rtt_count, capacity))
+      let first = Int(segment.rtt_count >= capacity ? segment.rtt_count % capacity : 0)
+      rtts = withUnsafeBytes(of: segment.rtt_us) { buffer in
+        let samples = buffer.bindMemory(to: UInt32.self)
+        return (0..<count).map { .microseconds(samples[(first + $0) % Int(capacity)]) }
+      }
+    }
+  }
+
+  /// Reads the segment of session `pid`.
+  static func read(pid: Int32) throws -> Snapshot {
+    guard let segment = scs_stats_attach(pid) else {
+      throw SegmentError(
+        description: "No stats for session \(pid): \(String(cString: strerror(errno)))")
+    }
+    defer { scs_stats_detach(segment) }
+
+    var snapshot = scs_stats_segment()
+    guard scs_stats_read(segment, &snapshot) == 0 else {
+      throw SegmentError(
+        description: "Cannot read stats of session \(pid): \(String(cString: strerror(errno)))")
+    }
+    return Snapshot(snapshot)
+  }
+
+  /// Process ids of running sessions that publish a segment.
+  static func sessions() -> [Int32] {
+    #if os(Linux)
+      let entries = (try? FileManager.default.contentsOfDirectory(atPath: "/dev/shm")) ?? []
+      return entries.compactMap { entry in
+        guard entry.hasPrefix("swiftconnect-"), let pid = Int32(entry.dropFirst(13)),
+          kill(pid, 0) == 0 || errno == EPERM
+        else { return nil }
+        return pid
+      }
+      .sorted()
+    #else
+      // Shared-memory names cannot be listed; every session also has a control socket
+      return ControlClient.runningSessions()
+    #endif
+  }
+
+  fileprivate static func string<Field>(_ field: Field) -> String {
+    withUnsafeBytes(of: field) { String(decoding: $0.prefix { $0 != 0 }, as: UTF8.self) }
+  }
+}
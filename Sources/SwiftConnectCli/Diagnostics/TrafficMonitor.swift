@@ -0,0 +1,42 @@
+//
+//  TrafficMonitor.swift
+//  SwiftConnectCli
+//
+//  Holds the counters of the current tunnel interface across reconnects
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// Gives timers synchronous access to the tunnel's traffic counters.
+///
+/// The session handler attaches the interface once the tunnel is up. Without
+/// an interface in this network namespace, e.g. with a userspace stack or
+/// --netns, `sample()` returns nil and callers fall back to asking the
+/// session for statistics.
+final class TrafficMonitor: Sendable {
+
+  private let counters = Mutex<InterfaceCounters?>(nil)
+
+  /// Starts reading `interface`; nil or an unknown name detaches.
+  func attach(interface: String?) {
+    let attached = interface.flatMap { InterfaceCounters(interface: $0) }
+    counters.withLock { $0 = attached }
+  }
+
+  /// Current counters, or nil if no interface is attached.
+  func sample() -> TrafficSample? {
+    counters.withLock { counters in
+      guard let sample = counters?.sample() else {
+        counters = nil
+        return nil
+      }
+      return sample
+    }
+  }
+}
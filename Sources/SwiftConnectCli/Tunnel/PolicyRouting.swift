@@ -0,0 +1,213 @@
+//
+//  PolicyRouting.swift
+//  SwiftConnectCli
+//
+//  Routes into a dedicated table selected by fwmark, uid range or cgroup
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// VPN routes confined to a dedicated routing table.
+///
+/// Instead of replacing routes in the main table, the tunnel's routes go into
+/// `table` and only traffic selected by `ip rule` lookups uses them: packets
+/// carrying `fwmark`, sockets owned by `uidRange`, or sockets of processes in
+/// the `cgroup` (marked by an nftables rule). Everything else keeps using the
+/// host's normal routes.
+struct PolicyRouting {
+
+  /// Routing table the VPN routes are installed into.
+  let table: UInt32
+
+  /// Packet mark selecting the table; also the mark nftables sets for `cgroup`.
+  var fwmark: UInt32?
+
+  /// `start-end` uid range whose sockets use the table.
+  var uidRange: String?
+
+  /// cgroup v2 path (relative to the cgroup root) whose sockets use the table.
+  var cgroup: String?
+
+  /// Mark used for cgroup selection when no explicit mark was given.
+  var effectiveMark: UInt32 {
+    fwmark ?? table
+  }
+
+  /// Name of the nftables table holding the cgroup marking rule.
+  var nftTable: String {
+    "swiftconnect_\(table)"
+  }
+
+  /// `ip rule` selectors, one rule each.
+  var ruleSelectors: [String] {
+    var selectors: [String] = []
+    if fwmark != nil || cgroup != nil {
+      selectors.append("fwmark \(effectiveMark)")
+    }
+    if let uidRange {
+      selectors.append("uidrange \(uidRange)")
+    }
+    return selectors
+  }
+
+  // MARK: - Script
+
+  /// Shell functions `policy_connect` and `policy_disconnect`, run with the
+  /// vpnc-script environment in place of the real vpnc-script. Commands are
+  /// prefixed with `$RUN` so they follow the tunnel into a network namespace.
+  var shellFunctions: String {
+    let rules = ruleSelectors.map(Shell.quote).joined(separator: " ")
+
+    var script = """
+      TABLE=\(table)
+      RULES="\(rules)"
+      SYSCTLS="/run/swiftconnect-table-$TABLE.sysctl"
+
+      policy_routes() {
+        family=$1 count=$2 prefix=$3
+        if [ "${count:-0}" -gt 0 ]; then
+          i=0
+          while [ "$i" -lt "$count" ]; do
+            eval "addr=\\${${prefix}_${i}_ADDR} len=\\${${prefix}_${i}_MASKLEN}"
+            $RUN ip "$family" route replace "$addr/$len" dev "$TUNDEV" table "$TABLE"
+            i=$((i + 1))
+          done
+        else
+          $RUN ip "$family" route replace default dev "$TUNDEV" table "$TABLE"
+        fi
+      }
+
+      policy_rules() {
+        action=$1 family=$2
+        eval "set -- $RULES"
+        for selector in "$@"; do
+          $RUN ip "$family" rule "$action" $selector lookup "$TABLE"
+        done
+      }
+
+      # Sets a sysctl, keeping its first value in $SYSCTLS for policy_disconnect
+      policy_sysctl() {
+        key=$1 value=$2
+        old=$($RUN sysctl -n "$key" 2>/dev/null) || return 0
+        grep -qs "^$key=" "$SYSCTLS" || echo "$key=$old" >> "$SYSCTLS"
+        $RUN sysctl -q -w "$key=$value"
+      }
+
+      policy_connect() {
+        $RUN ip link set dev "$TUNDEV" up mtu "${INTERNAL_IP4_MTU:-1400}" || return 1
+        if [ -n "$INTERNAL_IP4_ADDRESS" ]; then
+          $RUN ip -4 addr add "$INTERNAL_IP4_ADDRESS/32" dev "$TUNDEV"
+          # Replies arrive on the tunnel while the main table routes their
+          # source elsewhere; strict reverse-path filtering would drop them
+          policy_sysctl "net.ipv4.conf.$TUNDEV.rp_filter" 2
+          policy_routes -4 "$CISCO_SPLIT_INC" CISCO_SPLIT_INC
+          # Never send the tunnel's own transport back into the tunnel
+          [ -n "$VPNGATEWAY" ] && [ "${VPNGATEWAY#*:}" = "$VPNGATEWAY" ] \\
+            && $RUN ip -4 route replace throw "$VPNGATEWAY/32" table "$TABLE"
+          policy_rules add -4
+        fi
+        if [ -n "$INTERNAL_IP6_NETMASK" ]; then
+          $RUN ip -6 addr add "$INTERNAL_IP6_NETMASK" dev "$TUNDEV"
+          policy_routes -6 "$CISCO_IPV6_SPLIT_INC" CISCO_IPV6_SPLIT_INC
+          [ -n "$VPNGATEWAY" ] && [ "${VPNGATEWAY#*:}" != "$VPNGATEWAY" ] \\
+            && $RUN ip -6 route replace throw "$VPNGATEWAY/128" table "$TABLE"
+          policy_rules add -6
+        fi
+
+      """
+
+    if fwmark != nil || cgroup != nil {
+      // Let the reverse-path check see the mark, so marked replies are
+      // validated against the VPN table as wg-quick does
+      script += """
+          policy_sysctl net.ipv4.conf.all.src_valid_mark 1
+
+        """
+    }
+
+    if let cgroup {
+      // socket cgroupv2 matches at the depth of the given path. The heredoc is
+      // quoted so the shell expands nothing in it; the path is validated too.
+      let level = cgroup.split(separator: "/").count
+      script += """
+          $RUN nft -f - <<'NFT'
+        table inet \(nftTable) {
+          chain output {
+            type route hook output priority mangle;
+            socket cgroupv2 level \(level) "\(cgroup)" meta mark set \(effectiveMark)
+          }
+        }
+        NFT
+
+        """
+    }
+
+    script += """
+      }
+
+      policy_disconnect() {
+        policy_rules del -4
+        policy_rules del -6
+        $RUN ip -4 route flush table "$TABLE"
+        $RUN ip -6 route flush table "$TABLE"
+        if [ -f "$SYSCTLS" ]; then
+          # The device's own settings went away with it; ignore those
+          while IFS= read -r setting; do
+            $RUN sysctl -q -w "$setting" 2>/dev/null
+          done < "$SYSCTLS"
+          rm -f "$SYSCTLS"
+        fi
+
+      """
+
+    if cgroup != nil {
+      script += "  $RUN nft delete table inet \(nftTable)\n"
+    }
+
+    script += "}\n"
+    return script
+  }
+
+  // MARK: - Validation
+
+  /// Error thrown when policy routing options are inconsistent.
+  struct ValidationError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  private static let cgroupCharacters: Set<Unicode.Scalar> = Set(
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-@/".unicodeScalars)
+
+  /// Checks that at least one selector is set and that each one is well formed.
+  func validate() throws {
+    guard fwmark != nil || uidRange != nil || cgroup != nil else {
+      throw ValidationError(
+        description: "--route-table needs --route-fwmark, --route-uid or --route-cgroup")
+    }
+    guard table > 0, table != 253, table != 254, table != 255 else {
+      throw ValidationError(description: "--route-table must not be a reserved table (253-255)")
+    }
+    if let uidRange {
+      let bounds = uidRange.split(separator: "-").compactMap { UInt32($0) }
+      guard bounds.count == 2, bounds[0] <= bounds[1] else {
+        throw ValidationError(description: "Invalid uid range '\(uidRange)'")
+      }
+    }
+    if let cgroup {
+      guard !cgroup.isEmpty, !cgroup.hasPrefix("/") else {
+        throw ValidationError(
+          description: "--route-cgroup must be relative to the cgroup root, e.g. system.slice/app.service"
+        )
+      }
+      // The path ends up in a root shell script and an nft string literal
+      guard cgroup.unicodeScalars.allSatisfy(Self.cgroupCharacters.contains) else {
+        throw ValidationError(
+          description: "--route-cgroup may only contain letters, digits and . _ - @ /")
+      }
+    }
+  }
+}
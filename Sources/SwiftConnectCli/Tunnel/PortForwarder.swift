@@ -0,0 +1,270 @@
+//
+//  PortForwarder.swift
+//  SwiftConnectCli
+//
+//  ssh -L style local port forwarding through the userspace stack
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// Accepts local connections and carries each one over the VPN.
+///
+/// Every accepted connection is relayed through the userspace stack's SOCKS5
+/// endpoint to the forward's remote host and port. Each direction runs a
+/// blocking copy loop with a large buffer on its own thread, and the forwarder
+/// keeps byte counts and connect latency for its stats line. The counters are
+/// atomics updated after every chunk, so they can be read at any moment
+/// without stalling a relay.
+final class PortForwarder: Sendable {
+
+  /// A `[bind_address:]port:host:hostport` forward specification.
+  struct Spec: CustomStringConvertible {
+    let listen: UserspaceStack.ListenAddress
+    let host: String
+    let port: UInt16
+
+    init?(_ string: String) {
+      // Split off host:hostport from the right so IPv6 bind addresses work
+      guard let portColon = string.lastIndex(of: ":"),
+        let port = UInt16(string[string.index(after: portColon)...])
+      else { return nil }
+
+      let head = string[..<portColon]
+      guard let hostColon = head.lastIndex(of: ":") else { return nil }
+
+      var host = String(head[head.index(after: hostColon)...])
+      if host.hasSuffix("]"), let open = head.lastIndex(of: "[") {
+        // [ipv6]:hostport
+        host = String(head[head.index(after: open)..<head.index(before: head.endIndex)])
+        guard let listen = UserspaceStack.ListenAddress(String(head[..<open].dropLast())) else {
+          return nil
+        }
+        self.listen = listen
+      } else {
+        guard let listen = UserspaceStack.ListenAddress(String(head[..<hostColon])) else {
+          return nil
+        }
+        self.listen = listen
+      }
+
+      guard !host.isEmpty else { return nil }
+      self.host = host
+      self.port = port
+    }
+
+    var description: String {
+      let target = host.contains(":") ? "[\(host)]:\(port)" : "\(host):\(port)"
+      return "\(listen) → \(target)"
+    }
+  }
+
+  /// A snapshot of the counters for one forward.
+  struct Stats {
+    var connections = 0
+    var active = 0
+    var failed = 0
+    var bytesOut: UInt64 = 0
+    var bytesIn: UInt64 = 0
+    var connectLatencyTotal: Duration = .zero
+    var connectLatencyMax: Duration = .zero
+
+    /// Mean time from accepting a connection to the remote end being reachable.
+    var averageConnectLatency: Duration {
+      let established = connections - failed
+      return established > 0 ? connectLatencyTotal / established : .zero
+    }
+  }
+
+  /// Size of each direction's copy buffer.
+  static let bufferSize = 256 * 1024
+
+  // Relaxed atomics: each counter is exact, a snapshot is not a consistent cut
+  private final class Counters: Sendable {
+    let connections = Atomic<Int>(0)
+    let active = Atomic<Int>(0)
+    let failed = Atomic<Int>(0)
+    let bytesOut = Atomic<UInt64>(0)
+    let bytesIn = Atomic<UInt64>(0)
+    let connectLatencyTotal = Atomic<Int64>(0)
+    let connectLatencyMax = Atomic<Int64>(0)
+  }
+
+  let spec: Spec
+  private let socks: UserspaceStack.ListenAddress
+  private let memory: PacketMemory?
+  private let counters = Counters()
+  private let listener = Atomic<Int32>(-1)
+
+  init(spec: Spec, socks: UserspaceStack.ListenAddress, memory: PacketMemory? = nil) {
+    self.spec = spec
+    self.socks = socks
+    self.memory = memory
+  }
+
+  /// Current counters.
+  var snapshot: Stats {
+    Stats(
+      connections: counters.connections.load(ordering: .relaxed),
+      active: counters.active.load(ordering: .relaxed),
+      failed: counters.failed.load(ordering: .relaxed),
+      bytesOut: counters.bytesOut.load(ordering: .relaxed),
+      bytesIn: counters.bytesIn.load(ordering: .relaxed),
+      connectLatencyTotal: .nanoseconds(counters.connectLatencyTotal.load(ordering: .relaxed)),
+      connectLatencyMax: .nanoseconds(counters.connectLatencyMax.load(ordering: .relaxed))
+    )
+  }
+
+  /// Binds and listens on the forward's local address without accepting yet.
+  func openListener() throws {
+    let fd = try Sockets.openListener(host: spec.listen.host, port: spec.listen.port)
+    listener.store(fd, ordering: .releasing)
+  }
+
+  /// Accepts connections in the background on the socket `openListener` bound.
+  func start() {
+    let listener = listener.load(ordering: .acquiring)
+    precondition(listener >= 0, "PortForwarder.start() before openListener()")
+
+    Threads.detach(name: "fwd-\(spec.listen.port)") { [self] in
+      while true {
+        let client = accept(listener, nil, nil)
+        guard client >= 0 else {
+          if errno == EINTR || errno == ECONNABORTED { continue }
+          print("⚠️  Warning: Forward \(spec) stopped accepting: \(String(cString: strerror(errno)))")
+          return
+        }
+        Threads.detach(name: "fwd-\(spec.listen.port)-c") { [self] in
+          relay(client)
+        }
+      }
+    }
+  }
+
+  // MARK: - Relaying
+
+  private func relay(_ client: Int32) {
+    let clock = ContinuousClock()
+    let accepted = clock.now
+    counters.connections.wrappingAdd(1, ordering: .relaxed)
+    counters.active.wrappingAdd(1, ordering: .relaxed)
+
+    guard let remote = openTunnel() else {
+      Probes.forwardOpen(
+        localPort: spec.listen.port, latency: accepted.duration(to: clock.now), ok: false)
+      close(client)
+      counters.failed.wrappingAdd(1, ordering: .relaxed)
+      counters.active.wrappingSubtract(1, ordering: .relaxed)
+      return
+    }
+
+    let latency = accepted.duration(to: clock.now)
+    Probes.forwardOpen(localPort: spec.listen.port, latency: latency, ok: true)
+    let latencyNanoseconds = Int64(Units.seconds(latency) * 1e9)
+    counters.connectLatencyTotal.wrappingAdd(latencyNanoseconds, ordering: .relaxed)
+    counters.connectLatencyMax.max(latencyNanoseconds, ordering: .relaxed)
+
+    // Upstream on a second thread, downstream on this one. Each side half-closes
+    // its peer on EOF; the last one finished closes both sockets.
+    let pending = PendingDirections()
+    let finish: @Sendable () -> Void = { [self] in
+      if pending.count.subtract(1, ordering: .acquiringAndReleasing).newValue == 0 {
+        close(client)
+        close(remote)
+        counters.active.wrappingSubtract(1, ordering: .relaxed)
+      }
+    }
+
+    Threads.detach(name: "fwd-\(spec.listen.port)-u") { [self] in
+      copy(from: client, to: remote, counter: counters.bytesOut)
+      finish()
+    }
+
+    copy(from: remote, to: client, counter: counters.bytesIn)
+    finish()
+  }
+
+  private final class PendingDirections: Sendable {
+    let count = Atomic<Int>(2)
+  }
+
+  // Copies until EOF or error, counting as it goes, then half-closes the destination.
+  private func copy(from source: Int32, to destination: Int32, counter: borrowing Atomic<UInt64>) {
+    // Preallocated buffers first; the heap once they are all in use
+    let pooled = memory?.take()
+    let buffer =
+      pooled ?? UnsafeMutableRawPointer.allocate(byteCount: Self.bufferSize, alignment: 16)
+    defer {
+      if let pooled {
+        memory?.give(back: pooled)
+      } else {
+        buffer.deallocate()
+      }
+    }
+
+    while true {
+      let count = read(source, buffer, Self.bufferSize)
+      if count < 0 && errno == EINTR { continue }
+      guard count > 0, Sockets.writeAll(destination, buffer, count) else { break }
+      counter.wrappingAdd(UInt64(count), ordering: .relaxed)
+    }
+
+    shutdown(destination, Int32(SHUT_WR))
+  }
+
+  // Connects to the SOCKS5 endpoint and asks it for the forward's target.
+  private func openTunnel() -> Int32? {
+    guard let fd = try? Sockets.openConnection(host: socks.host ?? "127.0.0.1", port: socks.port)
+    else { return nil }
+
+    var ok = false
+    defer {
+      if !ok { close(fd) }
+    }
+
+    // Greeting: version 5, one method, no authentication
+    var reply = [UInt8](repeating: 0, count: 262)
+    let greeting: [UInt8] = [5, 1, 0]
+    guard Sockets.writeAll(fd, greeting, greeting.count),
+      Sockets.readExactly(fd, &reply, 2), reply[0] == 5, reply[1] == 0
+    else { return nil }
+
+    // CONNECT by domain name so the stack resolves through the VPN's DNS
+    let hostBytes = Array(spec.host.utf8)
+    guard hostBytes.count <= 255 else { return nil }
+    let request: [UInt8] =
+      [5, 1, 0, 3, UInt8(hostBytes.count)] + hostBytes
+      + [UInt8(spec.port >> 8), UInt8(spec.port & 0xff)]
+    guard Sockets.writeAll(fd, request, request.count),
+      Sockets.readExactly(fd, &reply, 4), reply[1] == 0
+    else { return nil }
+
+    // Skip the bound address: IPv4, domain name or IPv6, followed by the port
+    let addressLength: Int
+    switch reply[3] {
+    case 1: addressLength = 4
+    case 4: addressLength = 16
+    case 3:
+      guard Sockets.readExactly(fd, &reply, 1) else { return nil }
+      addressLength = Int(reply[0])
+    default: return nil
+    }
+    guard Sockets.readExactly(fd, &reply, addressLength + 2) else { return nil }
+
+    ok = true
+    return fd
+  }
+}
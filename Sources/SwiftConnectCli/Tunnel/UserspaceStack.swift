@@ -0,0 +1,94 @@
+//
+//  UserspaceStack.swift
+//  SwiftConnectCli
+//
+//  Terminates the tunnel in a userspace TCP/IP stack instead of a TUN device
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+/// A userspace TCP/IP stack that libopenconnect hands tunnel packets to.
+///
+/// The stack runs as a tunsocks/ocproxy-compatible helper that libopenconnect
+/// starts as its tun script: packets are exchanged over a socketpair instead of
+/// a kernel TUN device, so no interface, routes or root privileges are needed.
+/// The helper exposes the VPN to local applications as SOCKS5 and HTTP CONNECT
+/// proxies, and ``PortForwarder`` builds port forwards on top of the former.
+struct UserspaceStack {
+
+  /// A local `[address:]port` to listen on.
+  struct ListenAddress: CustomStringConvertible {
+    let host: String?
+    let port: UInt16
+
+    init(host: String?, port: UInt16) {
+      self.host = host
+      self.port = port
+    }
+
+    /// Parses `port`, `host:port` or `[ipv6]:port`.
+    init?(_ string: String) {
+      if let port = UInt16(string) {
+        self.host = nil
+        self.port = port
+        return
+      }
+
+      guard let colon = string.lastIndex(of: ":"),
+        let port = UInt16(string[string.index(after: colon)...])
+      else { return nil }
+
+      var host = String(string[..<colon])
+      if host.hasPrefix("[") && host.hasSuffix("]") {
+        host = String(host.dropFirst().dropLast())
+      }
+      guard !host.isEmpty else { return nil }
+
+      self.host = host
+      self.port = port
+    }
+
+    /// Form accepted by the helper's listen options.
+    var description: String {
+      guard let host else { return String(port) }
+      return host.contains(":") ? "[\(host)]:\(port)" : "\(host):\(port)"
+    }
+  }
+
+  /// Helper executable implementing the stack.
+  var helper: String
+
+  /// SOCKS5 proxy listen address.
+  var socksListen: ListenAddress?
+
+  /// HTTP CONNECT proxy listen address.
+  var httpListen: ListenAddress?
+
+  /// Command line libopenconnect runs as its tun script.
+  var tunScript: String {
+    var arguments = [helper]
+    if let socksListen {
+      arguments += ["-D", socksListen.description]
+    }
+    if let httpListen {
+      arguments += ["-H", httpListen.description]
+    }
+    return Shell.commandLine(arguments)
+  }
+
+  /// Human-readable list of the endpoints the stack exposes.
+  var endpoints: [String] {
+    var endpoints: [String] = []
+    if let socksListen {
+      endpoints.append("SOCKS5 \(socksListen)")
+    }
+    if let httpListen {
+      endpoints.append("HTTP \(httpListen)")
+    }
+    return endpoints
+  }
+}
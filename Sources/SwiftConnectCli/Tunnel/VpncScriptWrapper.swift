@@ -0,0 +1,181 @@
+//
+//  VpncScriptWrapper.swift
+//  SwiftConnectCli
+//
+//  Generated vpnc-script wrapper that changes where the tunnel is configured
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// A generated wrapper around the system vpnc-script.
+///
+/// libopenconnect runs the vpnc-script to configure the TUN device, routes and
+/// DNS. The wrapper can run that script inside a network namespace, or replace
+/// its routing with ``PolicyRouting``, without the rest of the tunnel setup
+/// knowing about either.
+struct VpncScriptWrapper {
+
+  /// Error thrown when the wrapper cannot be set up.
+  struct SetupError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  /// Locations distributions install vpnc-script to, in order of preference.
+  static let candidatePaths = [
+    "/etc/vpnc/vpnc-script",
+    "/usr/share/vpnc-scripts/vpnc-script",
+    "/usr/local/etc/vpnc/vpnc-script",
+    "/opt/homebrew/etc/vpnc/vpnc-script",
+  ]
+
+  /// The vpnc-script the wrapper delegates to.
+  let vpncScript: String
+
+  /// Network namespace the TUN device, routes and DNS are moved into.
+  var namespace: String?
+
+  /// Dedicated routing table used instead of the main one.
+  var policyRouting: PolicyRouting?
+
+  /// Finds the vpnc-script to wrap, preferring an explicit path.
+  static func locateVpncScript(_ explicitPath: String?) throws -> String {
+    if let explicitPath {
+      guard FileManager.default.isExecutableFile(atPath: explicitPath) else {
+        throw SetupError(description: "vpnc-script '\(explicitPath)' is not executable")
+      }
+      return explicitPath
+    }
+
+    guard let path = candidatePaths.first(where: FileManager.default.isExecutableFile(atPath:))
+    else {
+      throw SetupError(
+        description: "No vpnc-script found in \(candidatePaths.joined(separator: ", "))")
+    }
+    return path
+  }
+
+  // MARK: - Network Namespaces
+
+  /// Checks that `name` exists and gives it its own resolv.conf.
+  ///
+  /// `ip netns exec` bind-mounts /etc/netns/<name>/resolv.conf over
+  /// /etc/resolv.conf when the file exists, so the DNS servers vpnc-script
+  /// writes stay inside the namespace instead of replacing the host's.
+  static func prepareNamespace(_ name: String) throws {
+    #if os(Linux)
+      guard !name.isEmpty, !name.contains("/") else {
+        throw SetupError(description: "Invalid network namespace name '\(name)'")
+      }
+      guard FileManager.default.fileExists(atPath: "/var/run/netns/\(name)") else {
+        throw SetupError(
+          description: "Network namespace '\(name)' does not exist (create it with 'ip netns add \(name)')"
+        )
+      }
+
+      let directory = "/etc/netns/\(name)"
+      let resolvConf = directory + "/resolv.conf"
+      if !FileManager.default.fileExists(atPath: resolvConf) {
+        do {
+          try FileManager.default.createDirectory(
+            atPath: directory, withIntermediateDirectories: true)
+          guard FileManager.default.createFile(atPath: resolvConf, contents: Data()) else {
+            throw SetupError(description: "Cannot create \(resolvConf)")
+          }
+        } catch let error as SetupError {
+          throw error
+        } catch {
+          throw SetupError(description: "Cannot create \(directory): \(error)")
+        }
+      }
+    #else
+      throw SetupError(description: "Network namespaces are only supported on Linux")
+    #endif
+  }
+
+  // MARK: - Installation
+
+  /// Shell script body, run by libopenconnect with the vpnc-script environment.
+  var script: String {
+    var lines = [
+      "#!/bin/sh",
+      "# Generated by swiftconnect-cli for pid \(getpid()); removed on disconnect.",
+      "VPNC_SCRIPT=\(Shell.quote(vpncScript))",
+    ]
+
+    // Everything below runs the real script through $RUN
+    if let namespace {
+      lines += [
+        "NETNS=\(Shell.quote(namespace))",
+        "RUN=\"ip netns exec $NETNS\"",
+        "",
+        "# The TUN file descriptor stays with openconnect in the root namespace,",
+        "# together with the transport socket; only the network device moves.",
+        "if [ \"$reason\" = connect ]; then",
+        "  ip link set dev \"$TUNDEV\" netns \"$NETNS\" || exit 1",
+        "fi",
+        "# pre-init only loads the tun module, which is not namespaced",
+        "[ \"$reason\" = pre-init ] && RUN=",
+      ]
+    } else {
+      lines.append("RUN=")
+    }
+
+    if let policyRouting {
+      // Policy routing configures the device and routes itself; DNS is left
+      // alone because only the selected traffic uses the tunnel
+      lines += [
+        "",
+        policyRouting.shellFunctions,
+        "case \"$reason\" in",
+        "  connect) policy_connect ;;",
+        "  disconnect) policy_disconnect ;;",
+        "  pre-init) $RUN \"$VPNC_SCRIPT\" ;;",
+        "esac",
+      ]
+    } else {
+      lines += ["", "$RUN \"$VPNC_SCRIPT\""]
+    }
+
+    lines += [
+      "status=$?",
+      "[ \"$reason\" = disconnect ] && rm -f \"$0\"",
+      "exit $status",
+    ]
+    return lines.joined(separator: "\n") + "\n"
+  }
+
+  /// Writes the wrapper to a private temporary file and returns its path.
+  func install() throws -> String {
+    let path = FileManager.default.temporaryDirectory
+      .appendingPathComponent("swiftconnect-vpnc-\(getpid())-\(UInt32.random(in: 0...UInt32.max))")
+      .path
+
+    let fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0o700)
+    guard fd >= 0 else {
+      throw SetupError(
+        description: "Cannot create vpnc-script wrapper '\(path)': \(String(cString: strerror(errno)))"
+      )
+    }
+    defer { close(fd) }
+
+    let bytes = Array(script.utf8)
+    guard Sockets.writeAll(fd, bytes, bytes.count) else {
+      throw SetupError(
+        description: "Cannot write vpnc-script wrapper '\(path)': \(String(cString: strerror(errno)))"
+      )
+    }
+    return path
+  }
+}
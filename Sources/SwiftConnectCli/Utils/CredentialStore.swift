@@ -0,0 +1,133 @@
+//
+//  CredentialStore.swift
+//  SwiftConnectCli
+//
+//  Cross-platform lookup of stored secrets
+//
+
+import Synchronization
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+#if canImport(Security)
+  import Security
+#endif
+
+// Utility for reading secrets from the platform credential store.
+// Uses the Keychain on Apple platforms and a private JSON file elsewhere.
+enum CredentialStore {
+
+  // Error thrown when a credential cannot be found or read.
+  struct LookupError: Error, CustomStringConvertible {
+    let description: String
+  }
+
+  // Returns the secret stored for the given service and account. A prefetched
+  // copy is used once and dropped, so later authentications read the store
+  // again and pick up a rotated password.
+  static func secret(service: String, account: String) throws -> String {
+    if let secret = prefetched.withLock({ $0.removeValue(forKey: key(service, account)) }) {
+      return secret
+    }
+    return try lookup(service: service, account: account)
+  }
+
+  // Looks up `entries` on a background thread so that the first
+  // secret(service:account:) call answers from memory. Failures are left for
+  // that call to report.
+  static func prefetch(_ entries: [(service: String, account: String)]) {
+    guard !entries.isEmpty else { return }
+    let entries = entries.map { [$0.service, $0.account] }
+    Threads.detach(name: "credentials") {
+      for entry in entries {
+        guard let secret = try? lookup(service: entry[0], account: entry[1]) else { continue }
+        prefetched.withLock { $0[key(entry[0], entry[1])] = secret }
+      }
+    }
+  }
+
+  private static let prefetched = Mutex<[String: String]>([:])
+
+  private static func key(_ service: String, _ account: String) -> String {
+    service + "\u{0}" + account
+  }
+
+  private static func lookup(service: String, account: String) throws -> String {
+    #if canImport(Security)
+      return try keychainSecret(service: service, account: account)
+    #else
+      return try fileSecret(service: service, account: account)
+    #endif
+  }
+
+  #if canImport(Security)
+    // Reads a generic password item from the user's Keychain.
+    private static func keychainSecret(service: String, account: String) throws -> String {
+      let query: [CFString: Any] = [
+        kSecClass: kSecClassGenericPassword,
+        kSecAttrService: service,
+        kSecAttrAccount: account,
+        kSecReturnData: true,
+        kSecMatchLimit: kSecMatchLimitOne,
+      ]
+
+      var item: CFTypeRef?
+      let status = SecItemCopyMatching(query as CFDictionary, &item)
+      guard status == errSecSuccess, let data = item as? Data,
+        let secret = String(data: data, encoding: .utf8)
+      else {
+        throw LookupError(
+          description: "No Keychain item for service '\(service)', account '\(account)' (\(status))"
+        )
+      }
+      return secret
+    }
+  #else
+    // Reads a secret from $XDG_CONFIG_HOME/swiftconnect-cli/credentials.json,
+    // laid out as { "<service>": { "<account>": "<secret>" } }.
+    // The file must not be readable by group or others.
+    private static func fileSecret(service: String, account: String) throws -> String {
+      let path = credentialsFilePath()
+
+      var info = stat()
+      guard stat(path, &info) == 0 else {
+        throw LookupError(description: "Credentials file '\(path)' does not exist")
+      }
+      guard info.st_mode & 0o077 == 0 else {
+        throw LookupError(description: "Credentials file '\(path)' must have mode 0600")
+      }
+
+      guard let data = FileManager.default.contents(atPath: path),
+        let store = try? JSONDecoder().decode([String: [String: String]].self, from: data)
+      else {
+        throw LookupError(description: "Credentials file '\(path)' is not valid JSON")
+      }
+
+      guard let secret = store[service]?[account] else {
+        throw LookupError(
+          description: "No credential for service '\(service)', account '\(account)' in '\(path)'"
+        )
+      }
+      return secret
+    }
+
+    private static func credentialsFilePath() -> String {
+      let environment = ProcessInfo.processInfo.environment
+      let configHome =
+        environment["XDG_CONFIG_HOME"] ?? (environment["HOME"] ?? "") + "/.config"
+      return configHome + "/swiftconnect-cli/credentials.json"
+    }
+  #endif
+}
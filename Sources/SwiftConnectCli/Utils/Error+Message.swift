@@ -0,0 +1,21 @@
+//
+//  Error+Message.swift
+//  SwiftConnectCli
+//
+//  User-facing text for errors without NSError bridging
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+extension Error {
+  /// The error's description for users: `errorDescription` for a
+  /// `LocalizedError`, otherwise its string representation.
+  /// `localizedDescription` needs full Foundation's NSError bridging.
+  var message: String {
+    (self as? LocalizedError)?.errorDescription ?? String(describing: self)
+  }
+}
@@ -0,0 +1,34 @@
+//
+//  Posix.swift
+//  SwiftConnectCli
+//
+//  libc calls under names that types cannot shadow
+//
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+// Utility for libc functions that a surrounding type hides: a `close()`
+// method hides close(2) and ParsableCommand's `exit(withError:)` hides
+// exit(3). Calling them here avoids qualifying them with a module name.
+enum Posix {
+
+  // Closes a file descriptor, ignoring errors.
+  static func close(_ fd: Int32) {
+    _ = closeDescriptor(fd)
+  }
+
+  // Runs atexit handlers and ends the process.
+  static func exit(_ status: Int32) -> Never {
+    exitProcess(status)
+  }
+}
+
+private func closeDescriptor(_ fd: Int32) -> Int32 { close(fd) }
+
+private func exitProcess(_ status: Int32) -> Never { exit(status) }
@@ -5,7 +5,11 @@
 //  Cross-platform privilege checking utility
 //
 
-import Foundation
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
 
 #if os(Windows)
   import WinSDK
@@ -13,6 +17,8 @@ import Foundation
   import Darwin
 #elseif canImport(Glibc)
   import Glibc
+#elseif canImport(Musl)
+  import Musl
 #endif
 
 // Utility for checking if the current process has elevated privileges.
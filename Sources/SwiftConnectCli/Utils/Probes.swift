@@ -0,0 +1,72 @@
+//
+//  Probes.swift
+//  SwiftConnectCli
+//
+//  Swift entry points for the USDT probes in CSwiftConnectSupport
+//
+
+import CSwiftConnectSupport
+import OpenConnectKit
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+// Static tracepoints for session events, attachable with bpftrace or perf.
+// Every function checks the probe's semaphore first, so arguments are only
+// built while a tracer is attached.
+enum Probes {
+
+  // Fires on every connection status change.
+  static func status(_ status: ConnectionStatus) {
+    guard scs_probe_status_enabled() != 0 else { return }
+
+    var detail = ""
+    switch status {
+    case .disconnected(let error):
+      detail = error?.message ?? ""
+    case .connecting(let stage):
+      detail = "\(stage)"
+    case .connected, .reconnecting, .disconnecting:
+      break
+    }
+    detail.withCString { scs_probe_status(status.code, $0) }
+  }
+
+  // Fires when an authentication form arrives.
+  static func authBegin(title: String?, fields: Int) {
+    guard scs_probe_auth_begin_enabled() != 0 else { return }
+    (title ?? "").withCString { scs_probe_auth_begin($0, Int32(fields)) }
+  }
+
+  // Fires when a filled form is handed back to the server.
+  static func authEnd(duration: Duration, answered: Int, prompted: Int) {
+    guard scs_probe_auth_end_enabled() != 0 else { return }
+    scs_probe_auth_end(nanoseconds(duration), Int32(answered), Int32(prompted))
+  }
+
+  // Fires when the session starts reconnecting.
+  static func reconnect(count: Int) {
+    guard scs_probe_reconnect_enabled() != 0 else { return }
+    scs_probe_reconnect(UInt64(count))
+  }
+
+  // Fires for every statistics sample.
+  static func stats(rxBytes: UInt64, txBytes: UInt64, rxPackets: UInt64, txPackets: UInt64) {
+    guard scs_probe_stats_enabled() != 0 else { return }
+    scs_probe_stats(rxBytes, txBytes, rxPackets, txPackets)
+  }
+
+  // Fires when a port-forward connection is set up through the tunnel, or fails.
+  static func forwardOpen(localPort: UInt16, latency: Duration, ok: Bool) {
+    guard scs_probe_forward_open_enabled() != 0 else { return }
+    scs_probe_forward_open(Int32(localPort), nanoseconds(latency), ok ? 1 : 0)
+  }
+
+  private static func nanoseconds(_ duration: Duration) -> UInt64 {
+    let (seconds, attoseconds) = duration.components
+    return UInt64(max(seconds, 0)) * 1_000_000_000 + UInt64(max(attoseconds, 0) / 1_000_000_000)
+  }
+}
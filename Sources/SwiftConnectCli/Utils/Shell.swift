@@ -0,0 +1,28 @@
+//
+//  Shell.swift
+//  SwiftConnectCli
+//
+//  Helpers for building POSIX shell command lines
+//
+
+// Utility for quoting values passed through /bin/sh.
+enum Shell {
+
+  // Single-quotes a value for POSIX shells: ' becomes '\''
+  static func quote(_ value: String) -> String {
+    "'" + value.replacing("'", with: "'\\''") + "'"
+  }
+
+  // Reverses quote(_:), returning unquoted values unchanged.
+  static func unquote<S: StringProtocol>(_ value: S) -> String {
+    guard value.count >= 2, value.first == "'", value.last == "'" else {
+      return String(value)
+    }
+    return String(value.dropFirst().dropLast()).replacing("'\\''", with: "'")
+  }
+
+  // Joins arguments into a single, safely quoted command line.
+  static func commandLine(_ arguments: [String]) -> String {
+    arguments.map(quote).joined(separator: " ")
+  }
+}
@@ -0,0 +1,243 @@
+//
+//  Sockets.swift
+//  SwiftConnectCli
+//
+//  Thin helpers over BSD sockets for local listeners and outbound connections
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+// Utility for creating TCP sockets with getaddrinfo, and local Unix sockets.
+enum Sockets {
+
+  // Error thrown when a socket operation fails.
+  struct SocketError: Error, CustomStringConvertible {
+    let description: String
+
+    init(_ operation: String, _ code: Int32 = errno) {
+      self.description = "\(operation): \(String(cString: strerror(code)))"
+    }
+
+    init(description: String) {
+      self.description = description
+    }
+  }
+
+  // Creates a listening TCP socket. A nil host binds to loopback.
+  static func openListener(host: String?, port: UInt16, backlog: Int32 = 128) throws -> Int32 {
+    try withAddress(host: host ?? "127.0.0.1", port: port, passive: true) { info in
+      let fd = socket(info.pointee.ai_family, info.pointee.ai_socktype, info.pointee.ai_protocol)
+      guard fd >= 0 else { throw SocketError("socket") }
+
+      var reuse: Int32 = 1
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, socklen_t(MemoryLayout<Int32>.size))
+
+      guard bind(fd, info.pointee.ai_addr, info.pointee.ai_addrlen) == 0 else {
+        let error = SocketError("bind \(host ?? "127.0.0.1"):\(port)")
+        close(fd)
+        throw error
+      }
+      guard listen(fd, backlog) == 0 else {
+        let error = SocketError("listen")
+        close(fd)
+        throw error
+      }
+      return fd
+    }
+  }
+
+  // Opens a TCP connection to host:port.
+  static func openConnection(host: String, port: UInt16) throws -> Int32 {
+    try withAddress(host: host, port: port, passive: false) { info in
+      let fd = socket(info.pointee.ai_family, info.pointee.ai_socktype, info.pointee.ai_protocol)
+      guard fd >= 0 else { throw SocketError("socket") }
+
+      guard connect(fd, info.pointee.ai_addr, info.pointee.ai_addrlen) == 0 else {
+        let error = SocketError("connect \(host):\(port)")
+        close(fd)
+        throw error
+      }
+      return fd
+    }
+  }
+
+  // Creates a listening Unix domain socket at `path`, replacing a stale one.
+  static func openUnixListener(path: String, backlog: Int32 = 16) throws -> Int32 {
+    try withUnixAddress(path: path) { address, length in
+      let fd = socket(AF_UNIX, streamType, 0)
+      guard fd >= 0 else { throw SocketError("socket") }
+
+      unlink(path)
+      guard bind(fd, address, length) == 0 else {
+        let error = SocketError("bind \(path)")
+        close(fd)
+        throw error
+      }
+      guard listen(fd, backlog) == 0 else {
+        let error = SocketError("listen")
+        close(fd)
+        throw error
+      }
+      return fd
+    }
+  }
+
+  // Connects to the Unix domain socket at `path`.
+  static func openUnixConnection(path: String) throws -> Int32 {
+    try withUnixAddress(path: path) { address, length in
+      let fd = socket(AF_UNIX, streamType, 0)
+      guard fd >= 0 else { throw SocketError("socket") }
+
+      guard connect(fd, address, length) == 0 else {
+        let error = SocketError("connect \(path)")
+        close(fd)
+        throw error
+      }
+      return fd
+    }
+  }
+
+  // Resolves host to a numeric address string, e.g. "192.0.2.1".
+  static func resolve(host: String, port: UInt16) throws -> String {
+    try withAddress(host: host, port: port, passive: false) { info in
+      // Large enough for any IPv6 address with a scope id
+      var buffer = [CChar](repeating: 0, count: 64)
+      guard
+        getnameinfo(
+          info.pointee.ai_addr, info.pointee.ai_addrlen, &buffer, socklen_t(buffer.count), nil, 0,
+          NI_NUMERICHOST) == 0
+      else {
+        throw SocketError(description: "Cannot format address of \(host)")
+      }
+      return String(cString: buffer)
+    }
+  }
+
+  // Returns a loopback TCP port that was free at the time of the call.
+  static func freeLoopbackPort() throws -> UInt16 {
+    let fd = try openListener(host: "127.0.0.1", port: 0, backlog: 1)
+    defer { close(fd) }
+
+    var address = sockaddr_in()
+    var length = socklen_t(MemoryLayout<sockaddr_in>.size)
+    let result = withUnsafeMutablePointer(to: &address) {
+      $0.withMemoryRebound(to: sockaddr.self, capacity: 1) { getsockname(fd, $0, &length) }
+    }
+    guard result == 0 else { throw SocketError("getsockname") }
+    return UInt16(bigEndian: address.sin_port)
+  }
+
+  // Writes the whole buffer, retrying on short writes.
+  static func writeAll(_ fd: Int32, _ buffer: UnsafeRawPointer, _ count: Int) -> Bool {
+    var offset = 0
+    while offset < count {
+      let written = write(fd, buffer + offset, count - offset)
+      if written < 0 && errno == EINTR { continue }
+      guard written > 0 else { return false }
+      offset += written
+    }
+    return true
+  }
+
+  // Reads exactly `count` bytes, failing on EOF.
+  static func readExactly(_ fd: Int32, _ buffer: UnsafeMutableRawPointer, _ count: Int) -> Bool {
+    var offset = 0
+    while offset < count {
+      let received = read(fd, buffer + offset, count - offset)
+      if received < 0 && errno == EINTR { continue }
+      guard received > 0 else { return false }
+      offset += received
+    }
+    return true
+  }
+
+  // Reads until EOF or `limit` bytes.
+  static func readToEnd(_ fd: Int32, limit: Int = 1 << 20) -> [UInt8] {
+    var data: [UInt8] = []
+    var chunk = [UInt8](repeating: 0, count: 4096)
+    while data.count < limit {
+      let received = read(fd, &chunk, chunk.count)
+      if received < 0 && errno == EINTR { continue }
+      guard received > 0 else { break }
+      data += chunk[..<received]
+    }
+    return data
+  }
+
+  // MARK: - Private
+
+  // Glibc imports socket types as an enum; Darwin and musl as plain constants
+  #if canImport(Darwin) || canImport(Musl)
+    private static let streamType = SOCK_STREAM
+  #else
+    private static let streamType = Int32(SOCK_STREAM.rawValue)
+  #endif
+
+  private static func withUnixAddress<T>(
+    path: String,
+    _ body: (UnsafePointer<sockaddr>, socklen_t) throws -> T
+  ) throws -> T {
+    var address = sockaddr_un()
+    let pathBytes = Array(path.utf8)
+    guard pathBytes.count < MemoryLayout.size(ofValue: address.sun_path) else {
+      throw SocketError(description: "Socket path too long: \(path)")
+    }
+    address.sun_family = sa_family_t(AF_UNIX)
+    withUnsafeMutableBytes(of: &address.sun_path) { $0.copyBytes(from: pathBytes) }
+
+    return try withUnsafePointer(to: &address) {
+      try $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+        try body($0, socklen_t(MemoryLayout<sockaddr_un>.size))
+      }
+    }
+  }
+
+  private static func withAddress<T>(
+    host: String,
+    port: UInt16,
+    passive: Bool,
+    _ body: (UnsafeMutablePointer<addrinfo>) throws -> T
+  ) throws -> T {
+    var hints = addrinfo()
+    hints.ai_family = AF_UNSPEC
+    #if canImport(Darwin) || canImport(Musl)
+      hints.ai_socktype = SOCK_STREAM
+    #else
+      hints.ai_socktype = Int32(SOCK_STREAM.rawValue)
+    #endif
+    hints.ai_flags = passive ? AI_PASSIVE : 0
+
+    var result: UnsafeMutablePointer<addrinfo>?
+    let status = getaddrinfo(host, String(port), &hints, &result)
+    guard status == 0, let first = result else {
+      throw SocketError(
+        description: "Cannot resolve \(host): \(String(cString: gai_strerror(status)))")
+    }
+    defer { freeaddrinfo(result) }
+
+    // Try each address in turn, reporting the last failure
+    var lastError: Error = SocketError(description: "No usable address for \(host)")
+    var candidate: UnsafeMutablePointer<addrinfo>? = first
+    while let info = candidate {
+      do {
+        return try body(info)
+      } catch {
+        lastError = error
+      }
+      candidate = info.pointee.ai_next
+    }
+    throw lastError
+  }
+}
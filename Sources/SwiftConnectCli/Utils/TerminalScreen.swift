@@ -0,0 +1,119 @@
+//
+//  TerminalScreen.swift
+//  SwiftConnectCli
+//
+//  Full-screen terminal drawing with damage tracking
+//
+
+import CSwiftConnectSupport
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+/// A full-screen view on the alternate screen buffer that redraws only what
+/// changed.
+///
+/// Callers draw a complete frame into a back buffer of cells, then
+/// `present()` compares it with what the terminal shows and writes cursor
+/// moves and text for the changed runs only, in a single write. A frame in
+/// which nothing changed writes nothing. Cells hold one single-width
+/// character each.
+final class TerminalScreen {
+
+  private(set) var rows = 24
+  private(set) var columns = 80
+
+  private var front: [[Character]] = []
+  private var back: [[Character]] = []
+  private var needsFullRedraw = true
+
+  /// Switches to the alternate screen and hides the cursor.
+  func enter() {
+    emit("\u{1B}[?1049h\u{1B}[?25l")
+  }
+
+  /// Restores the cursor and the original screen contents.
+  func leave() {
+    emit("\u{1B}[0m\u{1B}[?25h\u{1B}[?1049l")
+  }
+
+  /// Starts a new frame, picking up terminal size changes.
+  func beginFrame() {
+    var rows: Int32 = 0
+    var columns: Int32 = 0
+    if scs_terminal_size(STDOUT_FILENO, &rows, &columns) == 0,
+      Int(rows) != self.rows || Int(columns) != self.columns
+    {
+      self.rows = Int(rows)
+      self.columns = Int(columns)
+      needsFullRedraw = true
+    }
+    back = Array(repeating: Array(repeating: " ", count: self.columns), count: self.rows)
+  }
+
+  /// Draws `text` at `row`, `column`, clipped to the screen.
+  func put(_ text: String, row: Int, column: Int = 0) {
+    guard row >= 0, row < rows else { return }
+    var position = column
+    for character in text where position < columns {
+      if position >= 0 {
+        back[row][position] = character
+      }
+      position += 1
+    }
+  }
+
+  /// Writes the cells that differ from the previous frame.
+  func present() {
+    var output = ""
+    if needsFullRedraw {
+      output += "\u{1B}[2J"
+      front = Array(repeating: Array(repeating: " ", count: columns), count: rows)
+      needsFullRedraw = false
+    }
+
+    for row in 0..<rows {
+      var column = 0
+      while column < columns {
+        guard back[row][column] != front[row][column] else {
+          column += 1
+          continue
+        }
+        // Extend the damaged run; short unchanged gaps are cheaper to rewrite
+        // than to skip with another cursor move
+        var end = column + 1
+        var unchanged = 0
+        while end < columns, unchanged < 8 {
+          unchanged = back[row][end] == front[row][end] ? unchanged + 1 : 0
+          end += 1
+        }
+        end -= unchanged
+
+        output += "\u{1B}[\(row + 1);\(column + 1)H"
+        output += String(back[row][column..<end])
+        column = end
+      }
+    }
+    front = back
+
+    if !output.isEmpty {
+      emit(output)
+    }
+  }
+
+  private func emit(_ text: String) {
+    let bytes = Array(text.utf8)
+    _ = Sockets.writeAll(STDOUT_FILENO, bytes, bytes.count)
+  }
+}
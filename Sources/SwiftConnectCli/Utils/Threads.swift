@@ -0,0 +1,79 @@
+//
+//  Threads.swift
+//  SwiftConnectCli
+//
+//  Named detached POSIX threads for blocking work
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+// Utility for running blocking loops on dedicated, named threads.
+// Names show up in debuggers, `top -H` and /proc/self/task/*/comm.
+enum Threads {
+
+  private final class Body {
+    let name: String
+    let work: () -> Void
+
+    init(name: String, work: @escaping () -> Void) {
+      self.name = name
+      self.work = work
+    }
+  }
+
+  // Starts `work` on a new detached thread. Names are truncated to the
+  // 15 characters Linux allows.
+  static func detach(name: String, _ work: @escaping @Sendable () -> Void) {
+    let context = Unmanaged.passRetained(Body(name: name, work: work)).toOpaque()
+
+    // pthread_t is a pointer on Darwin and musl, an integer on Glibc
+    #if canImport(Darwin) || canImport(Musl)
+      var thread: pthread_t?
+    #else
+      var thread = pthread_t()
+    #endif
+
+    let result = pthread_create(&thread, nil, { context in
+      #if canImport(Darwin)
+        let body = Unmanaged<Body>.fromOpaque(context).takeRetainedValue()
+        pthread_setname_np(String(body.name.prefix(15)))
+      #else
+        let body = Unmanaged<Body>.fromOpaque(context!).takeRetainedValue()
+        pthread_setname_np(pthread_self(), String(body.name.prefix(15)))
+      #endif
+      body.work()
+      return nil
+    }, context)
+
+    guard result == 0 else {
+      Unmanaged<Body>.fromOpaque(context).release()
+      print("⚠️  Warning: Could not start thread '\(name)': \(String(cString: strerror(result)))")
+      return
+    }
+
+    #if canImport(Darwin) || canImport(Musl)
+      pthread_detach(thread!)
+    #else
+      pthread_detach(thread)
+    #endif
+  }
+
+  // Blocks the calling thread for `duration`, resuming after signals.
+  static func sleep(_ duration: Duration) {
+    let (seconds, attoseconds) = duration.components
+    var remaining = timespec(tv_sec: Int(max(seconds, 0)), tv_nsec: Int(attoseconds / 1_000_000_000))
+    while nanosleep(&remaining, &remaining) != 0 && errno == EINTR {}
+  }
+}
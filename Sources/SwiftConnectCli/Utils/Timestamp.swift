@@ -0,0 +1,64 @@
+//
+//  Timestamp.swift
+//  SwiftConnectCli
+//
+//  Local-time timestamps for log and status lines
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(Darwin)
+  import Darwin
+#elseif canImport(Glibc)
+  import Glibc
+#elseif canImport(Musl)
+  import Musl
+#endif
+
+// Utility for fixed-format local timestamps. Formatted from localtime_r
+// directly, so printing a log line needs no DateFormatter, locale data or ICU.
+enum Timestamp {
+
+  // "HH:mm:ss", or "HH:mm:ss.SSS" with milliseconds.
+  static func time(_ date: Date = Date(), milliseconds: Bool = false) -> String {
+    let parts = localTime(date)
+    var text =
+      Units.padded(parts.tm_hour, width: 2) + ":" + Units.padded(parts.tm_min, width: 2) + ":"
+      + Units.padded(parts.tm_sec, width: 2)
+    if milliseconds {
+      let fraction = date.timeIntervalSince1970 - date.timeIntervalSince1970.rounded(.down)
+      text += "." + Units.padded(min(Int(fraction * 1000), 999), width: 3)
+    }
+    return text
+  }
+
+  // "yyyy-MM-dd HH:mm:ss", or "yyyy-MM-dd HH:mm" without seconds.
+  static func dateTime(_ date: Date, seconds: Bool = true) -> String {
+    let parts = localTime(date)
+    var text =
+      "\(parts.tm_year + 1900)-" + Units.padded(parts.tm_mon + 1, width: 2) + "-"
+      + Units.padded(parts.tm_mday, width: 2) + " " + Units.padded(parts.tm_hour, width: 2) + ":"
+      + Units.padded(parts.tm_min, width: 2)
+    if seconds {
+      text += ":" + Units.padded(parts.tm_sec, width: 2)
+    }
+    return text
+  }
+
+  // MARK: - Private
+
+  // localtime_r need not read TZ itself; do it once up front
+  private static let timeZoneLoaded: Void = tzset()
+
+  private static func localTime(_ date: Date) -> tm {
+    _ = timeZoneLoaded
+    var seconds = time_t(date.timeIntervalSince1970.rounded(.down))
+    var parts = tm()
+    localtime_r(&seconds, &parts)
+    return parts
+  }
+}
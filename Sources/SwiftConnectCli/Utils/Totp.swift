@@ -0,0 +1,83 @@
+//
+//  Totp.swift
+//  SwiftConnectCli
+//
+//  RFC 6238 time-based one-time password generation
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+#if canImport(CryptoKit)
+  import CryptoKit
+#else
+  import Crypto
+#endif
+
+// Generates time-based one-time passwords (RFC 6238, HMAC-SHA1).
+enum Totp {
+
+  // Error thrown when a TOTP secret is not valid base32.
+  struct InvalidSecretError: Error, CustomStringConvertible {
+    let description = "TOTP secret is not valid base32"
+  }
+
+  // Returns the code for the time step containing `date`.
+  static func code(
+    secret: String,
+    digits: Int = 6,
+    period: Int = 30,
+    date: Date = Date()
+  ) throws -> String {
+    guard let key = decodeBase32(secret) else {
+      throw InvalidSecretError()
+    }
+
+    var counter = UInt64(date.timeIntervalSince1970 / Double(period)).bigEndian
+    let message = withUnsafeBytes(of: &counter) { Data($0) }
+    let mac = Array(HMAC<Insecure.SHA1>.authenticationCode(for: message, using: SymmetricKey(data: key)))
+
+    // Dynamic truncation (RFC 4226 section 5.3)
+    let offset = Int(mac[mac.count - 1] & 0x0f)
+    let binary =
+      (UInt32(mac[offset] & 0x7f) << 24)
+      | (UInt32(mac[offset + 1]) << 16)
+      | (UInt32(mac[offset + 2]) << 8)
+      | UInt32(mac[offset + 3])
+
+    var modulus: UInt32 = 1
+    for _ in 0..<digits { modulus *= 10 }
+
+    let value = String(binary % modulus)
+    return String(repeating: "0", count: digits - value.count) + value
+  }
+
+  // Decodes RFC 4648 base32, ignoring case, spaces and padding.
+  private static func decodeBase32(_ string: String) -> Data? {
+    var output = Data()
+    var buffer: UInt32 = 0
+    var bits = 0
+
+    for scalar in string.uppercased().unicodeScalars {
+      let value: UInt32
+      switch scalar {
+      case "A"..."Z": value = scalar.value - 65
+      case "2"..."7": value = scalar.value - 50 + 26
+      case " ", "=", "-": continue
+      default: return nil
+      }
+
+      buffer = (buffer << 5) | value
+      bits += 5
+      if bits >= 8 {
+        bits -= 8
+        output.append(UInt8((buffer >> UInt32(bits)) & 0xff))
+      }
+    }
+
+    return output.isEmpty ? nil : output
+  }
+}
@@ -0,0 +1,100 @@
+//
+//  Units.swift
+//  SwiftConnectCli
+//
+//  Compact formatting of byte counts, rates and durations for status output
+//
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+// Utility for formatting quantities in status lines.
+enum Units {
+
+  // Formats a byte count with binary prefixes, e.g. "12.3 MiB".
+  static func bytes(_ count: UInt64) -> String {
+    let units = ["B", "KiB", "MiB", "GiB", "TiB", "PiB"]
+    var value = Double(count)
+    var unit = 0
+    while value >= 1024 && unit < units.count - 1 {
+      value /= 1024
+      unit += 1
+    }
+    return unit == 0 ? "\(count) B" : decimal(value, places: 1) + " " + units[unit]
+  }
+
+  // Formats a rate in bits per second with decimal prefixes, e.g. "84.2 Mbit/s".
+  static func bitRate(bytesPerSecond: Double) -> String {
+    let units = ["bit/s", "kbit/s", "Mbit/s", "Gbit/s", "Tbit/s"]
+    var value = bytesPerSecond * 8
+    var unit = 0
+    while value >= 1000 && unit < units.count - 1 {
+      value /= 1000
+      unit += 1
+    }
+    return decimal(value, places: 1) + " " + units[unit]
+  }
+
+  // Formats a duration in milliseconds, e.g. "0.412 ms".
+  static func milliseconds(_ duration: Duration) -> String {
+    decimal(seconds(duration) * 1e3, places: 3) + " ms"
+  }
+
+  // Formats an elapsed time coarsely, e.g. "2h 05m" or "42s".
+  static func elapsed(_ duration: Duration) -> String {
+    let total = max(duration.components.seconds, 0)
+    let hours = total / 3600
+    let minutes = total / 60 % 60
+    if hours > 0 {
+      return "\(hours)h " + padded(minutes, width: 2) + "m"
+    }
+    return minutes > 0 ? "\(minutes)m " + padded(total % 60, width: 2) + "s" : "\(total)s"
+  }
+
+  // Formats `value` with a fixed number of decimals, like printf's "%.Nf"
+  // without going through C varargs or a locale.
+  static func decimal(_ value: Double, places: Int) -> String {
+    var scale: Double = 1
+    for _ in 0..<places { scale *= 10 }
+    let scaled = (abs(value) * scale).rounded()
+    guard value.isFinite, scaled < 1e18 else { return "\(value)" }
+
+    let units = UInt64(scaled)
+    let divisor = UInt64(scale)
+    let sign = value < 0 && units > 0 ? "-" : ""
+    guard places > 0 else { return sign + "\(units)" }
+    return sign + "\(units / divisor)." + padded(units % divisor, width: places)
+  }
+
+  // Formats an integer zero-padded to `width` digits, like printf's "%0Nd".
+  static func padded<T: BinaryInteger>(_ value: T, width: Int) -> String {
+    let digits = String(value)
+    return String(repeating: "0", count: max(width - digits.count, 0)) + digits
+  }
+
+  // Left-aligns `text` in a column of `width` characters, truncating longer text.
+  static func column(_ text: String, width: Int) -> String {
+    String(text.prefix(width)) + String(repeating: " ", count: max(width - text.count, 0))
+  }
+
+  // Parses durations such as "90s", "15m", "6h" or "2d"; a bare number is seconds.
+  static func parseDuration(_ text: String) -> Duration? {
+    let multipliers: [Character: Double] = ["s": 1, "m": 60, "h": 3600, "d": 86400]
+    var number = Substring(text)
+    var multiplier = 1.0
+    if let last = text.last, let unit = multipliers[last] {
+      number = number.dropLast()
+      multiplier = unit
+    }
+    guard let value = Double(number), value >= 0 else { return nil }
+    return .seconds(value * multiplier)
+  }
+
+  // Converts a duration to fractional seconds.
+  static func seconds(_ duration: Duration) -> Double {
+    Double(duration.components.seconds) + Double(duration.components.attoseconds) / 1e18
+  }
+}
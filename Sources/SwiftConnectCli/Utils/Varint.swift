@@ -0,0 +1,45 @@
+//
+//  Varint.swift
+//  SwiftConnectCli
+//
+//  LEB128 variable-length integers for compact binary files
+//
+
+// Utility for encoding unsigned integers in 7-bit groups, low bits first.
+enum Varint {
+
+  // Appends `value` to `bytes`, using 1 byte below 128 and at most 10.
+  static func append(_ value: UInt64, to bytes: inout [UInt8]) {
+    var value = value
+    while value >= 0x80 {
+      bytes.append(UInt8(truncatingIfNeeded: value) | 0x80)
+      value >>= 7
+    }
+    bytes.append(UInt8(value))
+  }
+
+  // Maps signed values to unsigned so small magnitudes stay short (zigzag).
+  static func append(signed value: Int64, to bytes: inout [UInt8]) {
+    append(UInt64(bitPattern: (value << 1) ^ (value >> 63)), to: &bytes)
+  }
+
+  // Reads a value at `offset`, advancing it; nil if the input ends first.
+  static func read<C: Collection<UInt8>>(_ bytes: C, at offset: inout C.Index) -> UInt64? {
+    var value: UInt64 = 0
+    var shift: UInt64 = 0
+    while offset < bytes.endIndex && shift < 64 {
+      let byte = bytes[offset]
+      bytes.formIndex(after: &offset)
+      value |= UInt64(byte & 0x7f) << shift
+      if byte & 0x80 == 0 { return value }
+      shift += 7
+    }
+    return nil
+  }
+
+  // Reads a zigzag-encoded signed value.
+  static func readSigned<C: Collection<UInt8>>(_ bytes: C, at offset: inout C.Index) -> Int64? {
+    guard let raw = read(bytes, at: &offset) else { return nil }
+    return Int64(bitPattern: raw >> 1) ^ -Int64(bitPattern: raw & 1)
+  }
+}
@@ -0,0 +1,189 @@
+//
+//  CaptureFilterTests.swift
+//  SwiftConnectCliTests
+//
+//  Filter expressions compiled to classic BPF and run against test packets
+//
+
+import CSwiftConnectSupport
+import Testing
+
+@testable import SwiftConnectCli
+
+struct CaptureFilterTests {
+
+  static let snaplen: UInt32 = 1500
+
+  // MARK: - Packets
+
+  static func ipv4(
+    protocol: UInt8, source: [UInt8], destination: [UInt8], ports: (UInt16, UInt16),
+    fragmentOffset: UInt16 = 0
+  ) -> [UInt8] {
+    var packet = [UInt8](repeating: 0, count: 40)
+    packet[0] = 0x45
+    packet[6] = UInt8(fragmentOffset >> 8)
+    packet[7] = UInt8(fragmentOffset & 0xff)
+    packet[9] = `protocol`
+    packet.replaceSubrange(12..<16, with: source)
+    packet.replaceSubrange(16..<20, with: destination)
+    packet.replaceSubrange(20..<24, with: bigEndian(ports.0) + bigEndian(ports.1))
+    return packet
+  }
+
+  static func ipv6(nextHeader: UInt8, source: [UInt8], destination: [UInt8], ports: (UInt16, UInt16))
+    -> [UInt8]
+  {
+    var packet = [UInt8](repeating: 0, count: 60)
+    packet[0] = 0x60
+    packet[6] = nextHeader
+    packet.replaceSubrange(8..<24, with: source)
+    packet.replaceSubrange(24..<40, with: destination)
+    packet.replaceSubrange(40..<44, with: bigEndian(ports.0) + bigEndian(ports.1))
+    return packet
+  }
+
+  static func bigEndian(_ value: UInt16) -> [UInt8] {
+    [UInt8(value >> 8), UInt8(value & 0xff)]
+  }
+
+  static let local: [UInt8] = [10, 0, 0, 2]
+  static let server: [UInt8] = [192, 168, 1, 10]
+  static let local6: [UInt8] = [0xfd, 0] + [UInt8](repeating: 0, count: 13) + [2]
+  static let server6: [UInt8] = [0x20, 0x01, 0x0d, 0xb8] + [UInt8](repeating: 0, count: 11) + [1]
+
+  static let https4 = ipv4(protocol: 6, source: local, destination: server, ports: (50_000, 443))
+  static let dns4 = ipv4(protocol: 17, source: local, destination: server, ports: (50_001, 53))
+  static let ping4 = ipv4(protocol: 1, source: server, destination: local, ports: (0, 0))
+  static let https6 = ipv6(nextHeader: 6, source: local6, destination: server6, ports: (50_000, 443))
+  static let ping6 = ipv6(nextHeader: 58, source: server6, destination: local6, ports: (0, 0))
+
+  // MARK: - Interpreter
+
+  // Runs `program` the way the kernel does: out-of-bounds loads reject
+  static func run(_ program: [scs_bpf_insn], on packet: [UInt8]) -> UInt32 {
+    var accumulator: UInt32 = 0
+    var index: UInt32 = 0
+    var pc = 0
+
+    func load(_ offset: Int, _ size: Int) -> UInt32? {
+      guard offset >= 0, offset + size <= packet.count else { return nil }
+      return packet[offset..<offset + size].reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+    }
+
+    while pc < program.count {
+      let instruction = program[pc]
+      pc += 1
+      let k = instruction.k
+      switch instruction.code {
+      case 0x20, 0x28, 0x30:
+        let size = instruction.code == 0x20 ? 4 : instruction.code == 0x28 ? 2 : 1
+        guard let value = load(Int(k), size) else { return 0 }
+        accumulator = value
+      case 0x48:
+        guard let value = load(Int(index) + Int(k), 2) else { return 0 }
+        accumulator = value
+      case 0xb1:
+        guard let value = load(Int(k), 1) else { return 0 }
+        index = (value & 0x0f) * 4
+      case 0x54:
+        accumulator &= k
+      case 0x15:
+        pc += Int(accumulator == k ? instruction.jt : instruction.jf)
+      case 0x45:
+        pc += Int(accumulator & k != 0 ? instruction.jt : instruction.jf)
+      case 0x06:
+        return k
+      default:
+        Issue.record("Unexpected opcode \(instruction.code)")
+        return 0
+      }
+    }
+    Issue.record("Program fell off the end")
+    return 0
+  }
+
+  static func accepts(_ filter: String, _ packet: [UInt8]) throws -> Bool {
+    let program = try CaptureFilter(filter).program(snaplen: snaplen)
+    return run(program, on: packet) == snaplen
+  }
+
+  // MARK: - Tests
+
+  @Test func emptyFilterAcceptsEverything() throws {
+    for packet in [Self.https4, Self.dns4, Self.ping4, Self.https6, Self.ping6] {
+      #expect(try Self.accepts("", packet))
+    }
+  }
+
+  @Test func protocols() throws {
+    #expect(try Self.accepts("tcp", Self.https4))
+    #expect(try Self.accepts("tcp", Self.https6))
+    #expect(try !Self.accepts("tcp", Self.dns4))
+    #expect(try Self.accepts("udp", Self.dns4))
+    #expect(try Self.accepts("icmp", Self.ping4))
+    #expect(try !Self.accepts("icmp", Self.ping6))
+    #expect(try Self.accepts("icmp6", Self.ping6))
+    #expect(try Self.accepts("ip", Self.dns4))
+    #expect(try !Self.accepts("ip", Self.https6))
+    #expect(try Self.accepts("ip6", Self.https6))
+  }
+
+  @Test func hosts() throws {
+    #expect(try Self.accepts("host 192.168.1.10", Self.https4))
+    #expect(try Self.accepts("dst host 192.168.1.10", Self.https4))
+    #expect(try !Self.accepts("src host 192.168.1.10", Self.https4))
+    #expect(try Self.accepts("src host 192.168.1.10", Self.ping4))
+    #expect(try !Self.accepts("host 192.168.1.11", Self.https4))
+    #expect(try Self.accepts("host 2001:db8::1", Self.https6))
+    #expect(try !Self.accepts("host 2001:db8::1", Self.https4))
+    #expect(try Self.accepts("src host fd00::2", Self.https6))
+  }
+
+  @Test func ports() throws {
+    #expect(try Self.accepts("port 443", Self.https4))
+    #expect(try Self.accepts("dst port 443", Self.https6))
+    #expect(try !Self.accepts("src port 443", Self.https4))
+    #expect(try Self.accepts("src port 50001", Self.dns4))
+    #expect(try !Self.accepts("port 443", Self.ping4))
+  }
+
+  @Test func portsSkipIPv4OptionsAndLaterFragments() throws {
+    // IHL 6: the transport header starts at 24
+    var withOptions = [UInt8](repeating: 0, count: 44)
+    withOptions[0] = 0x46
+    withOptions[9] = 6
+    withOptions.replaceSubrange(24..<28, with: Self.bigEndian(50_000) + Self.bigEndian(443))
+    #expect(try Self.accepts("port 443", withOptions))
+
+    let fragment = Self.ipv4(
+      protocol: 6, source: Self.local, destination: Self.server, ports: (50_000, 443),
+      fragmentOffset: 185)
+    #expect(try !Self.accepts("port 443", fragment))
+  }
+
+  @Test func booleanOperators() throws {
+    #expect(try Self.accepts("tcp and port 443", Self.https4))
+    #expect(try !Self.accepts("tcp and port 53", Self.https4))
+    #expect(try Self.accepts("tcp or udp", Self.dns4))
+    #expect(try !Self.accepts("not ip", Self.dns4))
+    #expect(try Self.accepts("not (tcp or udp)", Self.ping4))
+    #expect(try Self.accepts("udp && ! port 443 || icmp", Self.dns4))
+    #expect(try Self.accepts("host 192.168.1.10 and (port 53 or port 443)", Self.dns4))
+  }
+
+  @Test func acceptedPacketsAreTruncatedToSnaplen() throws {
+    let program = try CaptureFilter("tcp").program(snaplen: 96)
+    #expect(Self.run(program, on: Self.https4) == 96)
+    #expect(Self.run(program, on: Self.dns4) == 0)
+  }
+
+  @Test(arguments: [
+    "tcp and", "port", "port 70000", "host 300.1.1.1", "src tcp", "(tcp", "tcp)", "sctp",
+  ])
+  func invalidExpressionsThrow(filter: String) {
+    #expect(throws: CaptureFilter.ParseError.self) {
+      _ = try CaptureFilter(filter).program(snaplen: Self.snaplen)
+    }
+  }
+}
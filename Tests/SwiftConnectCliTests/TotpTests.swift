@@ -0,0 +1,54 @@
+//
+//  TotpTests.swift
+//  SwiftConnectCliTests
+//
+//  RFC 6238 appendix B test vectors (HMAC-SHA1)
+//
+
+import Testing
+
+@testable import SwiftConnectCli
+
+#if canImport(FoundationEssentials)
+  import FoundationEssentials
+#else
+  import Foundation
+#endif
+
+struct TotpTests {
+
+  // The ASCII key "12345678901234567890" in base32
+  static let secret = "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ"
+
+  @Test(arguments: [
+    (59.0, "94287082"),
+    (1_111_111_109, "07081804"),
+    (1_111_111_111, "14050471"),
+    (1_234_567_890, "89005924"),
+    (2_000_000_000, "69279037"),
+    (20_000_000_000, "65353130"),
+  ])
+  func rfc6238Vectors(time: Double, expected: String) throws {
+    let code = try Totp.code(
+      secret: Self.secret, digits: 8, period: 30, date: Date(timeIntervalSince1970: time))
+    #expect(code == expected)
+  }
+
+  @Test func sixDigitsKeepLeadingZeros() throws {
+    let code = try Totp.code(
+      secret: Self.secret, digits: 6, date: Date(timeIntervalSince1970: 1_111_111_109))
+    #expect(code == "081804")
+  }
+
+  @Test func secretIgnoresCaseSpacesAndPadding() throws {
+    let date = Date(timeIntervalSince1970: 59)
+    let spaced = try Totp.code(secret: "gezd gnbv gy3t qojq gezd gnbv gy3t qojq====", digits: 8, date: date)
+    #expect(spaced == "94287082")
+  }
+
+  @Test func invalidSecretThrows() {
+    #expect(throws: Totp.InvalidSecretError.self) {
+      try Totp.code(secret: "not base32!")
+    }
+  }
+}
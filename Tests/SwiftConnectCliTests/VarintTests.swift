@@ -0,0 +1,65 @@
+//
+//  VarintTests.swift
+//  SwiftConnectCliTests
+//
+//  LEB128 and zigzag round trips
+//
+
+import Testing
+
+@testable import SwiftConnectCli
+
+struct VarintTests {
+
+  @Test(arguments: [
+    UInt64(0), 1, 127, 128, 255, 300, 16_383, 16_384, UInt64(UInt32.max), UInt64.max - 1, UInt64.max,
+  ])
+  func unsignedRoundTrip(value: UInt64) {
+    var bytes: [UInt8] = []
+    Varint.append(value, to: &bytes)
+    var offset = bytes.startIndex
+    #expect(Varint.read(bytes, at: &offset) == value)
+    #expect(offset == bytes.endIndex)
+  }
+
+  @Test func encodedLengths() {
+    for (value, length) in [(UInt64(0), 1), (127, 1), (128, 2), (16_383, 2), (16_384, 3), (.max, 10)] {
+      var bytes: [UInt8] = []
+      Varint.append(value, to: &bytes)
+      #expect(bytes.count == length, "\(value)")
+    }
+  }
+
+  @Test(arguments: [Int64(0), 1, -1, 63, -64, 64, -65, .max, .min])
+  func signedRoundTrip(value: Int64) {
+    var bytes: [UInt8] = []
+    Varint.append(signed: value, to: &bytes)
+    var offset = bytes.startIndex
+    #expect(Varint.readSigned(bytes, at: &offset) == value)
+  }
+
+  @Test func smallMagnitudesStayShort() {
+    var bytes: [UInt8] = []
+    Varint.append(signed: -64, to: &bytes)
+    #expect(bytes == [127])
+  }
+
+  @Test func sequenceReadsBackInOrder() {
+    let values: [UInt64] = [5, 300, 0, 1 << 40]
+    var bytes: [UInt8] = []
+    values.forEach { Varint.append($0, to: &bytes) }
+
+    var offset = bytes.startIndex
+    let decoded = values.map { _ in Varint.read(bytes, at: &offset) }
+    #expect(decoded == values.map(Optional.some))
+    #expect(Varint.read(bytes, at: &offset) == nil)
+  }
+
+  @Test func truncatedInputIsNil() {
+    var bytes: [UInt8] = []
+    Varint.append(1 << 20, to: &bytes)
+    let truncated = bytes.dropLast()
+    var offset = truncated.startIndex
+    #expect(Varint.read(truncated, at: &offset) == nil)
+  }
+}
@@ -0,0 +1,68 @@
+#!/bin/sh
+#
+# bench-pps.sh - packets per second through a running tunnel and what they
+# cost the session in CPU.
+#
+# Usage: scripts/bench-pps.sh <tun-interface> <iperf3-server> [seconds] [payload] [pid]
+#
+# Sends unthrottled UDP with iperf3 (small payloads by default, to stress the
+# per-packet path rather than bandwidth) to an iperf3 server behind the VPN.
+# While it runs, the tunnel interface's packet counters and the session's CPU
+# time are sampled. Prints tx/rx packets per second, the session's CPU use,
+# and CPU time per packet, which is the figure to compare between transport
+# modes.
+#
+# With NETNS set, iperf3 runs inside that network namespace, e.g. for a
+# session started with --netns, or a veth test bed between two namespaces.
+# <pid> defaults to the only running swiftconnect-cli process.
+
+set -eu
+
+interface=${1:?usage: $0 <tun-interface> <iperf3-server> [seconds] [payload] [pid]}
+server=${2:?usage: $0 <tun-interface> <iperf3-server> [seconds] [payload] [pid]}
+seconds=${3:-10}
+payload=${4:-64}
+pid=${5:-$(pgrep -x swiftconnect-cli)}
+
+in_netns() {
+  if [ -n "${NETNS:-}" ]; then
+    ip netns exec "$NETNS" "$@"
+  else
+    "$@"
+  fi
+}
+
+counter() {
+  in_netns cat "/sys/class/net/$interface/statistics/$1"
+}
+
+# utime + stime of the session, in clock ticks
+cpu_ticks() {
+  sed 's/.*) //' "/proc/$pid/stat" | awk '{ print $12 + $13 }'
+}
+
+tx_before=$(counter tx_packets)
+rx_before=$(counter rx_packets)
+cpu_before=$(cpu_ticks)
+start=$(date +%s%N)
+
+in_netns iperf3 -u -c "$server" -b 0 -l "$payload" -t "$seconds" >/dev/null
+
+end=$(date +%s%N)
+tx_after=$(counter tx_packets)
+rx_after=$(counter rx_packets)
+cpu_after=$(cpu_ticks)
+
+awk -v tx=$((tx_after - tx_before)) -v rx=$((rx_after - rx_before)) \
+  -v ticks=$((cpu_after - cpu_before)) -v hz="$(getconf CLK_TCK)" \
+  -v ns=$((end - start)) -v payload="$payload" '
+  BEGIN {
+    elapsed = ns / 1e9
+    cpu = ticks / hz
+    packets = tx + rx
+    printf "payload        %d bytes\n", payload
+    printf "tx             %.0f pps\n", tx / elapsed
+    printf "rx             %.0f pps\n", rx / elapsed
+    printf "session CPU    %.1f%%\n", cpu / elapsed * 100
+    if (packets > 0) printf "CPU per packet %.2f us\n", cpu / packets * 1e6
+  }'
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# bench-proxy.sh - compare transfer throughput over the TUN path and the
+# userspace stack proxy path.
+#
+# Usage: scripts/bench-proxy.sh <url> [socks-port] [runs]
+#
+# Start one tunnel with the default TUN path and one with
+# '--proxy-listen <socks-port>' against the same gateway, then point <url>
+# at a large file behind the VPN.
+
+set -eu
+
+url=${1:?usage: $0 <url> [socks-port] [runs]}
+socks_port=${2:-1080}
+runs=${3:-5}
+
+measure() {
+  label=$1
+  shift
+  total=0
+  i=0
+  while [ "$i" -lt "$runs" ]; do
+    speed=$(curl -s -o /dev/null -w '%{speed_download}' "$@" "$url")
+    total=$(echo "$total + $speed" | bc)
+    i=$((i + 1))
+  done
+  printf '%-10s %10.2f MB/s (mean of %d)\n' "$label" "$(echo "$total / $runs / 1048576" | bc -l)" "$runs"
+}
+
+measure "tun"
+measure "socks5" --socks5-hostname "127.0.0.1:$socks_port"
@@ -0,0 +1,150 @@
+#!/bin/sh
+#
+# bench-startup.sh - start-up and cold-connect benchmark.
+#
+# Usage: scripts/bench-startup.sh <binary>... [-- runs]
+#
+# Environment:
+#   BENCH_SERVER      gateway URL of the test gateway
+#   BENCH_AUTH_RULES  --auth-rules file answering the login forms
+#   BENCH_ARGS        extra connect options (the certificate must be trusted)
+#   BENCH_SOCKS_PORT  local SOCKS5 port of the session (default 1091)
+#
+# Every binary (e.g. the dynamic and static builds from scripts/build-linux.sh)
+# is started with --startup-trace and --proxy-listen, cold (page cache dropped,
+# needs root) and warm, until it reports Connected. Per binary and cache state
+# the mean time since exec is printed for each phase:
+#
+#   load+relocate     exec to the C constructors: mapping and relocating libraries
+#   main              first Swift code
+#   parsed            arguments parsed, connect command entered
+#   configured        configuration built, auth rules loaded
+#   session           VpnSession created
+#   connect-returned  connect() returned
+#   connected         .connected reported
+#
+# Phases are measured from the moment just before exec, which the script hands
+# over in SWIFTCONNECT_EXEC_REALTIME_NS; the kernel's own process start time
+# is only good to 10 ms. Sampling the clock and forking add the same small
+# constant to every binary.
+#
+# With glibc's dynamic loader, ld.so's own statistics (LD_DEBUG=statistics)
+# add its total start-up time and the parts spent loading and relocating
+# objects, in CPU cycles.
+
+set -eu
+
+runs=5
+binaries=""
+while [ $# -gt 0 ]; do
+  case "$1" in
+  --)
+    runs=${2:?missing run count}
+    shift 2
+    ;;
+  *)
+    binaries="$binaries $1"
+    shift
+    ;;
+  esac
+done
+[ -n "$binaries" ] || {
+  echo "usage: $0 <binary>... [-- runs]" >&2
+  exit 2
+}
+server=${BENCH_SERVER:?set BENCH_SERVER}
+rules=${BENCH_AUTH_RULES:?set BENCH_AUTH_RULES}
+port=${BENCH_SOCKS_PORT:-1091}
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+drop_caches() {
+  sync
+  echo 3 >/proc/sys/vm/drop_caches 2>/dev/null
+}
+
+# Runs one session to Connected and appends "phase=ms" pairs to <results>
+run_once() {
+  binary=$1
+  results=$2
+  log=$work/log
+  rm -f "$work"/ld.*
+
+  # shellcheck disable=SC2086
+  SWIFTCONNECT_EXEC_REALTIME_NS=$(date +%s%N) \
+    LD_DEBUG=statistics LD_DEBUG_OUTPUT="$work/ld" \
+    "$binary" connect "$server" --auth-rules "$rules" --startup-trace \
+    --proxy-listen "127.0.0.1:$port" ${BENCH_ARGS:-} </dev/null >"$log" 2>&1 &
+  pid=$!
+
+  # The trace line is flushed as soon as it is printed (stdout is also
+  # line-buffered when redirected), so this never waits on a full buffer
+  tries=0
+  until grep -q '^startup-trace ' "$log"; do
+    tries=$((tries + 1))
+    if [ "$tries" -gt 3000 ] || ! kill -0 "$pid" 2>/dev/null; then
+      echo "$(basename "$binary"): session did not connect" >&2
+      cat "$log" >&2
+      kill "$pid" 2>/dev/null || true
+      exit 1
+    fi
+    sleep 0.01
+  done
+  kill -INT "$pid"
+  wait "$pid" || true
+
+  line=$(grep '^startup-trace ' "$log" | sed 's/^startup-trace //')
+
+  # ld.so's own statistics, in CPU cycles, from the session process only
+  if [ -f "$work/ld.$pid" ]; then
+    line="$line $(awk '
+      /total startup time in dynamic loader/ && !total { total = $(NF-1) }
+      /time needed for relocation/ && !relocation { relocation = $(NF-2) }
+      /time needed to load objects/ && !load { load = $(NF-2) }
+      END { printf "ld.so-cycles=%d ld.so-relocation-cycles=%d ld.so-load-cycles=%d", total, relocation, load }
+    ' "$work/ld.$pid")"
+  fi
+  echo "$line" >>"$results"
+}
+
+report() {
+  label=$1
+  results=$2
+  awk -v label="$label" '
+    {
+      for (i = 1; i <= NF; i++) {
+        split($i, kv, "=")
+        if (!(kv[1] in sum)) order[++n] = kv[1]
+        sum[kv[1]] += kv[2]
+        count[kv[1]]++
+      }
+    }
+    END {
+      printf "%s\n", label
+      for (i = 1; i <= n; i++) {
+        key = order[i]
+        unit = key ~ /cycles/ ? "cycles" : "ms"
+        printf "  %-24s %14.3f %s\n", key, sum[key] / count[key], unit
+      }
+    }
+  ' "$results"
+}
+
+for binary in $binaries; do
+  for cache in cold warm; do
+    results=$work/$cache
+    : >"$results"
+    if [ "$cache" = cold ] && ! drop_caches; then
+      echo "$(basename "$binary") cold: skipped, dropping the page cache needs root"
+      continue
+    fi
+    i=0
+    while [ "$i" -lt "$runs" ]; do
+      [ "$cache" = cold ] && drop_caches
+      run_once "$binary" "$results"
+      i=$((i + 1))
+    done
+    report "$(basename "$binary") $cache (mean of $runs)" "$results"
+  done
+done
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# build-linux.sh - release builds of swiftconnect-cli for Linux.
+#
+# Usage: scripts/build-linux.sh [dynamic|static-stdlib|musl] [output-dir]
+#
+#   dynamic        plain 'swift build -c release'; links the Swift runtime,
+#                  Foundation and libopenconnect dynamically
+#   static-stdlib  Swift runtime and Foundation linked in (glibc stays dynamic)
+#   musl           fully static binary through the static Linux SDK
+#                  (swift sdk install ...static-linux...); runs on any distro
+#
+# static-stdlib and musl link libopenconnect and its dependencies (gnutls,
+# nettle, libxml2, zlib, ...) from static archives under OPENCONNECT_PREFIX,
+# found with 'pkg-config --static'. For musl they must be built against musl,
+# e.g. in an Alpine container. The binary is copied to
+# <output-dir>/swiftconnect-cli-<variant> (default .build/dist).
+
+set -eu
+
+variant=${1:-dynamic}
+out=${2:-.build/dist}
+arch=$(uname -m)
+
+# Linker flags for a static libopenconnect; the prefix is searched first, so
+# its archives win over shared libraries of the same name
+static_openconnect() {
+  prefix=${OPENCONNECT_PREFIX:?set OPENCONNECT_PREFIX to a prefix with static libopenconnect}
+  flags="-Xlinker -L$prefix/lib"
+  for lib in $(PKG_CONFIG_PATH="$prefix/lib/pkgconfig" PKG_CONFIG_ALL_STATIC=1 \
+    pkg-config --static --libs-only-l openconnect); do
+    flags="$flags -Xlinker $lib"
+  done
+  echo "$flags"
+}
+
+case "$variant" in
+dynamic)
+  swift build -c release --product swiftconnect-cli
+  bin=$(swift build -c release --show-bin-path)
+  ;;
+static-stdlib)
+  # shellcheck disable=SC2046
+  swift build -c release --product swiftconnect-cli --static-swift-stdlib \
+    $(static_openconnect)
+  bin=$(swift build -c release --static-swift-stdlib --show-bin-path)
+  ;;
+musl)
+  sdk=${SWIFT_SDK:-$arch-swift-linux-musl}
+  # shellcheck disable=SC2046
+  swift build -c release --product swiftconnect-cli --swift-sdk "$sdk" \
+    $(static_openconnect)
+  bin=$(swift build -c release --swift-sdk "$sdk" --show-bin-path)
+  ;;
+*)
+  echo "usage: $0 [dynamic|static-stdlib|musl] [output-dir]" >&2
+  exit 2
+  ;;
+esac
+
+mkdir -p "$out"
+cp "$bin/swiftconnect-cli" "$out/swiftconnect-cli-$variant"
+echo "$out/swiftconnect-cli-$variant"
@@ -0,0 +1,101 @@
+#!/bin/sh
+#
+# build-pgo.sh - profile-guided, link-time optimized release build of
+# swiftconnect-cli, compared against the plain '-c release' build.
+#
+# Usage: scripts/build-pgo.sh [rounds]
+#
+# Steps, all under .build/pgo:
+#   1. plain 'swift build -c release' (the baseline)
+#   2. instrumented build (-profile-generate for Swift,
+#      -fprofile-instr-generate for C)
+#   3. training run of scripts/pgo-workload.sh (see there for PGO_* settings)
+#   4. llvm-profdata merge into swiftconnect.profdata
+#   5. optimized build: profile use, cross-module optimization and ThinLTO
+#      across Swift and C, linked with lld
+#   6. the workload again with the baseline and the optimized binary
+#
+# With OPENCONNECT_SRC pointing at a libopenconnect source tree (configured
+# with autogen.sh), libopenconnect is built statically with the same
+# instrumentation and optimization and linked in, so its crypto and packet
+# paths are trained too. Otherwise the system libopenconnect is used as is.
+
+set -eu
+
+rounds=${1:-3}
+work=.build/pgo
+mkdir -p "$work"
+work=$(cd "$work" && pwd)
+
+toolchain=$(dirname "$(readlink -f "$(command -v swift)")")
+profdata_tool=${LLVM_PROFDATA:-$toolchain/llvm-profdata}
+profile=$work/swiftconnect.profdata
+
+# Builds libopenconnect into <prefix> with <cflags> and prints the linker
+# flags for it; nothing when OPENCONNECT_SRC is unset
+openconnect() {
+  [ -n "${OPENCONNECT_SRC:-}" ] || return 0
+  prefix=$1
+  cflags=$2
+  build=$prefix-build
+  rm -rf "$build" && mkdir -p "$build"
+  (
+    cd "$build"
+    "$OPENCONNECT_SRC/configure" --prefix="$prefix" --disable-shared --enable-static \
+      --disable-nls CC=clang CFLAGS="-O2 $cflags" LDFLAGS="-fuse-ld=lld $cflags" >/dev/null
+    make -j"$(nproc)" install >/dev/null
+  )
+  flags="-Xlinker -L$prefix/lib"
+  for lib in $(PKG_CONFIG_PATH="$prefix/lib/pkgconfig" PKG_CONFIG_ALL_STATIC=1 \
+    pkg-config --static --libs-only-l openconnect); do
+    flags="$flags -Xlinker $lib"
+  done
+  echo "$flags"
+}
+
+# swift build into <build-path> with the remaining arguments; prints the binary
+build() {
+  path=$1
+  shift
+  swift build -c release --product swiftconnect-cli --build-path "$path" "$@" >&2
+  echo "$(swift build -c release --build-path "$path" --show-bin-path)/swiftconnect-cli"
+}
+
+echo "==> Baseline build"
+plain=$(build "$work/plain")
+
+echo "==> Instrumented build"
+gen_flags="-fprofile-instr-generate"
+oc=$(openconnect "$work/openconnect-gen" "$gen_flags")
+# shellcheck disable=SC2086
+instrumented=$(build "$work/gen" -Xswiftc -profile-generate -Xcc $gen_flags $oc)
+
+echo "==> Training run"
+rm -f "$work"/*.profraw
+LLVM_PROFILE_FILE="$work/train-%p.profraw" scripts/pgo-workload.sh "$instrumented" "$rounds"
+"$profdata_tool" merge -o "$profile" "$work"/*.profraw
+
+echo "==> Optimized build"
+use_flags="-fprofile-instr-use=$profile -flto=thin"
+oc=$(openconnect "$work/openconnect-use" "$use_flags")
+# shellcheck disable=SC2086
+optimized=$(build "$work/use" \
+  -Xswiftc -profile-use="$profile" -Xswiftc -cross-module-optimization \
+  -Xcc -fprofile-instr-use="$profile" -Xcc -flto=thin \
+  --experimental-lto-mode=thin -Xswiftc -use-ld=lld $oc)
+cp "$optimized" "$work/swiftconnect-cli-pgo"
+
+echo "==> Baseline workload"
+scripts/pgo-workload.sh "$plain" "$rounds" | tee "$work/plain.txt"
+echo "==> Optimized workload"
+scripts/pgo-workload.sh "$optimized" "$rounds" | tee "$work/pgo.txt"
+
+value() { sed -n "s/^$1=//p" "$2"; }
+echo
+printf '%-12s %12s %16s\n' build connect-ms throughput-MB/s
+printf '%-12s %12s %16s\n' release "$(value connect_ms "$work/plain.txt")" \
+  "$(value throughput_mbs "$work/plain.txt")"
+printf '%-12s %12s %16s\n' pgo+lto "$(value connect_ms "$work/pgo.txt")" \
+  "$(value throughput_mbs "$work/pgo.txt")"
+echo
+echo "Optimized binary: $work/swiftconnect-cli-pgo"
@@ -0,0 +1,85 @@
+#!/bin/sh
+#
+# measure-startup.sh - compare size, start-up time and memory of builds.
+#
+# Usage: scripts/measure-startup.sh <binary>... [-- runs]
+#
+# For each binary prints its size (as built and stripped), the number of
+# shared libraries it loads, the mean cold and warm time of '--version', and
+# the peak RSS of the same run. Cold runs drop the page cache first, which
+# needs root; without it they are reported as warm. Build the variants with
+# scripts/build-linux.sh.
+
+set -eu
+
+runs=10
+binaries=""
+while [ $# -gt 0 ]; do
+  case "$1" in
+  --)
+    runs=${2:?missing run count}
+    shift 2
+    ;;
+  *)
+    binaries="$binaries $1"
+    shift
+    ;;
+  esac
+done
+[ -n "$binaries" ] || {
+  echo "usage: $0 <binary>... [-- runs]" >&2
+  exit 2
+}
+
+now_ns() { date +%s%N; }
+
+drop_caches() {
+  sync
+  echo 3 >/proc/sys/vm/drop_caches 2>/dev/null
+}
+
+# Mean wall time of '--version' in milliseconds; "cold" drops caches before each run
+mean_ms() {
+  binary=$1
+  mode=$2
+  total=0
+  i=0
+  while [ "$i" -lt "$runs" ]; do
+    if [ "$mode" = cold ]; then
+      drop_caches || {
+        echo "n/a"
+        return
+      }
+    fi
+    start=$(now_ns)
+    "$binary" --version >/dev/null
+    end=$(now_ns)
+    total=$((total + end - start))
+    i=$((i + 1))
+  done
+  echo "$total $runs" | awk '{ printf "%.1f", $1 / $2 / 1e6 }'
+}
+
+printf '%-32s %10s %10s %6s %10s %10s %9s\n' binary size stripped libs cold-ms warm-ms rss-kib
+for binary in $binaries; do
+  size=$(stat -c %s "$binary")
+  stripped=$(mktemp)
+  strip -o "$stripped" "$binary" 2>/dev/null || cp "$binary" "$stripped"
+  stripped_size=$(stat -c %s "$stripped")
+  rm -f "$stripped"
+
+  # A static binary has no loader work at all
+  libs=$(ldd "$binary" 2>/dev/null | grep -c '=>' || true)
+
+  # Warm the cache once before the warm runs
+  "$binary" --version >/dev/null
+  cold=$(mean_ms "$binary" cold)
+  warm=$(mean_ms "$binary" warm)
+  rss=n/a
+  if [ -x /usr/bin/time ]; then
+    rss=$(/usr/bin/time -f %M "$binary" --version 2>&1 >/dev/null | tail -n 1)
+  fi
+
+  printf '%-32s %10s %10s %6s %10s %10s %9s\n' "$(basename "$binary")" \
+    "$size" "$stripped_size" "$libs" "$cold" "$warm" "$rss"
+done
@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# pgo-workload.sh - connect, bulk transfer and reconnect against a test
+# gateway; the training run for scripts/build-pgo.sh and its benchmark.
+#
+# Usage: scripts/pgo-workload.sh <swiftconnect-cli binary> [rounds]
+#
+# Environment:
+#   PGO_SERVER      gateway URL, e.g. https://127.0.0.1:8443 (ocserv test setup)
+#   PGO_AUTH_RULES  --auth-rules file answering the login forms
+#   PGO_URL         large file behind the VPN used for the bulk transfer
+#   PGO_SOCKS_PORT  local SOCKS5 port of the session (default 1090)
+#   PGO_ARGS        extra connect options (the gateway certificate must be
+#                   trusted, since nobody answers the prompt)
+#
+# Each round starts a session with --proxy-listen (no root needed), waits
+# until it reports Connected, downloads PGO_URL through it and disconnects;
+# the next round is the reconnect. Prints per-round connect time and
+# throughput, then their means as "connect_ms=" and "throughput_mbs=".
+
+set -eu
+
+binary=${1:?usage: $0 <binary> [rounds]}
+rounds=${2:-3}
+server=${PGO_SERVER:?set PGO_SERVER}
+rules=${PGO_AUTH_RULES:?set PGO_AUTH_RULES}
+url=${PGO_URL:?set PGO_URL}
+port=${PGO_SOCKS_PORT:-1090}
+
+log=$(mktemp)
+trap 'rm -f "$log"' EXIT
+
+now_ms() { echo $(($(date +%s%N) / 1000000)); }
+
+total_connect=0
+total_speed=0
+round=1
+while [ "$round" -le "$rounds" ]; do
+  start=$(now_ms)
+  # shellcheck disable=SC2086
+  "$binary" connect "$server" --auth-rules "$rules" \
+    --proxy-listen "127.0.0.1:$port" ${PGO_ARGS:-} </dev/null >"$log" 2>&1 &
+  pid=$!
+
+  # Up to 30 s for authentication and tunnel set-up. The CLI line-buffers
+  # stdout when it is not a terminal, so the status line reaches the log as
+  # soon as it is printed
+  deadline=$((start + 30000))
+  until grep -q 'Status: Connected' "$log"; do
+    if [ "$(now_ms)" -gt "$deadline" ] || ! kill -0 "$pid" 2>/dev/null; then
+      echo "round $round: session did not connect" >&2
+      cat "$log" >&2
+      kill "$pid" 2>/dev/null || true
+      exit 1
+    fi
+    sleep 0.01
+  done
+  connect=$(($(now_ms) - start))
+
+  speed=$(curl -s -o /dev/null -w '%{speed_download}' \
+    --socks5-hostname "127.0.0.1:$port" "$url")
+
+  kill -INT "$pid"
+  wait "$pid" || true
+
+  printf 'round %d: connect %d ms, %.2f MB/s\n' "$round" "$connect" \
+    "$(echo "$speed / 1048576" | bc -l)"
+  total_connect=$((total_connect + connect))
+  total_speed=$(echo "$total_speed + $speed" | bc)
+  round=$((round + 1))
+done
+
+echo "connect_ms=$((total_connect / rounds))"
+printf 'throughput_mbs=%.2f\n' "$(echo "$total_speed / $rounds / 1048576" | bc -l)"
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# symbolize-folded.sh - resolve module+offset frames written by
+# 'swiftconnect-cli profile' into function names.
+#
+# Usage: scripts/symbolize-folded.sh <profile.folded> [sysroot]
+#
+# Run it where the same binaries (with debug info) are found at the paths
+# recorded in the profile, or under [sysroot]. Needs llvm-symbolizer; Swift
+# names are demangled by swift-demangle when it is on PATH.
+
+set -eu
+
+profile=${1:?usage: $0 <profile.folded> [sysroot]}
+sysroot=${2:-}
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# Every distinct module+offset frame, once
+tr ';' '\n' <"$profile" | sed 's/ [0-9]*$//' | grep '+0x[0-9a-f]*$' | sort -u >"$tmp/frames"
+
+# llvm-symbolizer reads "<module> <address>" lines and prints the function,
+# its location and a blank line for each
+sed 's/^\(.*\)+\(0x[0-9a-f]*\)$/"\1" \2/' "$tmp/frames" |
+  sed "s|^\"|\"$sysroot|" |
+  llvm-symbolizer --no-inlines --functions=linkage --demangle |
+  awk 'NR % 3 == 1' >"$tmp/names"
+
+if command -v swift-demangle >/dev/null 2>&1; then
+  swift-demangle --simplified <"$tmp/names" >"$tmp/demangled"
+  mv "$tmp/demangled" "$tmp/names"
+fi
+
+# Unresolved frames keep their module+offset; names must not contain ';'
+paste -d '\t' "$tmp/frames" "$tmp/names" | awk -F '\t' '
+  FNR == NR {
+    name = $2
+    gsub(/;/, ",", name)
+    if (name == "" || name == "??") name = $1
+    map[$1] = name
+    next
+  }
+  {
+    match($0, / [0-9]+$/)
+    stack = substr($0, 1, RSTART - 1)
+    count = substr($0, RSTART + 1)
+    n = split(stack, frames, ";")
+    out = frames[1]
+    for (i = 2; i <= n; i++) out = out ";" ((frames[i] in map) ? map[frames[i]] : frames[i])
+    print out, count
+  }
+' - "$profile"